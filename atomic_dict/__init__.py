@@ -1,4 +1,4 @@
-from atomic_dict.core import AtomicDict, AtomicSet
+from atomic_dict.core import AtomicCache, AtomicDict, AtomicSet, AtomicVector
 
 __version__ = '0.5.0'
-__all__ = ["AtomicDict", "AtomicSet"]
+__all__ = ["AtomicCache", "AtomicDict", "AtomicSet", "AtomicVector"]
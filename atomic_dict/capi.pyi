@@ -1,12 +1,45 @@
-from typing import Any
+from typing import Any, Iterator
+
+from _typeshed import ReadableBuffer, WriteableBuffer
+
+HEADER_BYTES: int
 
 def get_pointer(x: Any) -> int: ...
+def read_layout(header: ReadableBuffer) -> tuple[int, int, int, int, bool, int, int, int, bool, bool, int]: ...
 
 class DictIterator:
+    def __iter__(self) -> DictIterator: ...
+    def __next__(self) -> tuple[tuple[int, ...], int | tuple[int, ...] | bool]: ...
     def key(self) -> tuple[int, ...] | None: ...
-    def value(self) -> int | None: ...
+    def value(self) -> int | tuple[int, ...] | None: ...
     def next(self) -> None: ...
 
+class AtomicValue16:
+    def load(self) -> int: ...
+    def store(self, x: int) -> None: ...
+    def swap(self, x: int) -> int: ...
+    def add(self, x: int) -> int: ...
+    def sub(self, x: int) -> int: ...
+    def band(self, x: int) -> int: ...
+    def bor(self, x: int) -> int: ...
+    def bxor(self, x: int) -> int: ...
+    def max(self, x: int) -> int: ...
+    def min(self, x: int) -> int: ...
+    def cas(self, expected: int, desired: int) -> int: ...
+
+class AtomicValue8:
+    def load(self) -> int: ...
+    def store(self, x: int) -> None: ...
+    def swap(self, x: int) -> int: ...
+    def add(self, x: int) -> int: ...
+    def sub(self, x: int) -> int: ...
+    def band(self, x: int) -> int: ...
+    def bor(self, x: int) -> int: ...
+    def bxor(self, x: int) -> int: ...
+    def max(self, x: int) -> int: ...
+    def min(self, x: int) -> int: ...
+    def cas(self, expected: int, desired: int) -> int: ...
+
 class AtomicValue32:
     def load(self) -> int: ...
     def store(self, x: int) -> None: ...
@@ -16,6 +49,8 @@ class AtomicValue32:
     def band(self, x: int) -> int: ...
     def bor(self, x: int) -> int: ...
     def bxor(self, x: int) -> int: ...
+    def max(self, x: int) -> int: ...
+    def min(self, x: int) -> int: ...
     def cas(self, expected: int, desired: int) -> int: ...
 
 class AtomicValue64:
@@ -27,10 +62,46 @@ class AtomicValue64:
     def band(self, x: int) -> int: ...
     def bor(self, x: int) -> int: ...
     def bxor(self, x: int) -> int: ...
+    def max(self, x: int) -> int: ...
+    def min(self, x: int) -> int: ...
     def cas(self, expected: int, desired: int) -> int: ...
 
+class AtomicEntry:
+    def __len__(self) -> int: ...
+    def __getitem__(self, field: int) -> AtomicValue8 | AtomicValue16 | AtomicValue32 | AtomicValue64: ...
+    def load(self) -> tuple[int, ...]: ...
+    def store(self, *values: int) -> None: ...
+    def add(self, *values: int) -> tuple[int, ...]: ...
+
 class AtomicArray:
-    def __init__(self, mv: memoryview, k64: int, k32: int, v64: int, v32: int) -> None: ...
-    def index(self, *args: int) -> AtomicValue32 | AtomicValue64 | bool: ...
+    def __init__(self, memory_view: memoryview, k64: int, k32: int, v64: int, v32: int, clearable: bool = False,
+                 k16: int = 0, v16: int = 0, v8: int = 0, cache: bool = False, dirty: bool = False) -> None: ...
+    def index(self, *args: int) -> AtomicValue8 | AtomicValue16 | AtomicValue32 | AtomicValue64 | AtomicEntry | bool: ...
+    def clear(self) -> None: ...
+    def get(self, *args: int) -> int | tuple[int, ...] | None: ...
+    def put(self, *args: int) -> None: ...
+    def stats(self) -> tuple[int, int, int]: ...
+    def rehash(self, source: AtomicArray, start: int, stop: int) -> None: ...
+    def recover(self) -> None: ...
+    def changed_since_and_reset(self) -> list[tuple[tuple[int, ...], int | tuple[int, ...] | bool]]: ...
     def iterator(self) -> DictIterator: ...
+    def __len__(self) -> int: ...
+    def __iter__(self) -> Iterator[tuple[tuple[int, ...], int | tuple[int, ...] | bool]]: ...
+    def __contains__(self, key: int | tuple[int, ...]) -> bool: ...
+
+class DictArray(AtomicArray):
+    def __getitem__(self, key: int | tuple[int, ...]) -> AtomicValue8 | AtomicValue16 | AtomicValue32 | AtomicValue64 | AtomicEntry: ...
+    def __setitem__(self, key: int | tuple[int, ...], value: int | tuple[int, ...]) -> None: ...
+    def __contains__(self, key: int | tuple[int, ...]) -> bool: ...
+
+class SetArray(AtomicArray):
+    def add(self, key: int | tuple[int, ...]) -> bool: ...
+    def __contains__(self, key: int | tuple[int, ...]) -> bool: ...
+
 
+class DirectArray:
+    def __init__(self, mv: memoryview, bits: int, length: int, /) -> None: ...
+    def index(self, offset: int) -> AtomicValue8 | AtomicValue16 | AtomicValue32 | AtomicValue64: ...
+    def gather(self, indices: ReadableBuffer, values: WriteableBuffer) -> None: ...
+    def scatter(self, indices: ReadableBuffer, values: ReadableBuffer) -> None: ...
+    def scatter_add(self, indices: ReadableBuffer, values: ReadableBuffer) -> None: ...
@@ -5,17 +5,22 @@
 
 PyDoc_STRVAR(
         atomic_dict_doc,
-        "Internal C bindings for AtomicArray and AtomicValue");
+        "Internal C bindings for AtomicArray, DictArray, SetArray, DirectArray and AtomicValue");
 
 PyDoc_STRVAR(
         atomic_array_doc,
         "An AtomicArray type\n"
         "\n"
-        "AtomicArray(memory_view)\n"
+        "AtomicArray(memory_view, k64, k32, v64, v32, clearable=False, k16=0, v16=0, v8=0, cache=False, dirty=False)\n"
         "\n"
         "Parameters\n"
         "----------\n"
-        "memory_view : The MemoryView to use as shared storage");
+        "memory_view : The MemoryView to use as shared storage (a header block followed by the cache blocks)\n"
+        "k64, k32, k16 : The number of 64-, 32- and 16-bit key cells per entry\n"
+        "v64, v32, v16, v8 : The number of 64-, 32-, 16- and 8-bit value cells per entry\n"
+        "clearable : Reserve a generation tag in every cache block so that clear() is O(1)\n"
+        "cache : Reserve a clock word in every cache block and evict rows when full; use get() and put()\n"
+        "dirty : Track changed blocks in a bitmap after the cache blocks, for changed_since_and_reset()");
 
 PyDoc_STRVAR(
         atomic_array_index_doc,
@@ -32,6 +37,110 @@ PyDoc_STRVAR(
         "----------\n"
         "The AtomicValue assigned to this key in the AtomicArray");
 
+PyDoc_STRVAR(
+        atomic_array_clear_doc,
+        "clear(self)\n"
+        "--\n"
+        "\n"
+        "Remove every key from a clearable AtomicArray in constant time.\n"
+        "Stale cache blocks are wiped lazily by the next probe which visits them.\n"
+        "AtomicValues retrieved before the clear must not be used afterwards.\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "None");
+
+PyDoc_STRVAR(
+        atomic_array_get_doc,
+        "get(self, key)\n"
+        "--\n"
+        "\n"
+        "Look up key in a cache-mode AtomicArray and mark it recently used\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "key : The non-zero key cells to look up\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "The value (or tuple of values) stored with key, or None on a miss");
+
+PyDoc_STRVAR(
+        atomic_array_put_doc,
+        "put(self, key, values)\n"
+        "--\n"
+        "\n"
+        "Store values with key in a cache-mode AtomicArray.\n"
+        "If no row near the key's home block is free, a row that was not used\n"
+        "recently is evicted (CLOCK). Racing puts of one key may store it twice;\n"
+        "the older copy is eventually evicted.\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "key : The non-zero key cells to store\n"
+        "values : One value per value cell\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "None");
+
+PyDoc_STRVAR(
+        atomic_array_stats_doc,
+        "stats(self)\n"
+        "--\n"
+        "\n"
+        "Read the shared cache counters, summed over every process\n"
+        "\n"
+        "Every process adds its counts in batches of up to 64, after publishing those of the caller.\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "A tuple of (hits, misses, evictions)");
+
+PyDoc_STRVAR(
+        atomic_array_rehash_doc,
+        "rehash(self, source, start, stop)\n"
+        "--\n"
+        "\n"
+        "Insert the entries in blocks [start, stop) of source into this AtomicArray.\n"
+        "The GIL is released, so threads may rehash disjoint ranges in parallel.\n"
+        "Entries whose key is already present overwrite its values.\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "source : An AtomicArray with the same key and value cells, of any capacity\n"
+        "start, stop : The range of source blocks to read\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "None");
+
+PyDoc_STRVAR(
+        atomic_array_recover_doc,
+        "recover(self)\n"
+        "--\n"
+        "\n"
+        "Release the block locks and finish the block wipes captured in a copy of the\n"
+        "shared memory which was taken while other processes were writing to it.\n"
+        "Call it before the copy is used, and never on memory in use.\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "None");
+
+PyDoc_STRVAR(
+        atomic_array_changes_doc,
+        "changed_since_and_reset(self)\n"
+        "--\n"
+        "\n"
+        "Read out the entries of every block changed since the last call, and mark\n"
+        "those blocks clean. Only the dirty blocks are visited. Entries are read\n"
+        "NON-ATOMICALLY; those removed by clear() or eviction are not reported.\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "A list of (key, value) tuples, as produced by iterating over the AtomicArray");
+
 PyDoc_STRVAR(
         atomic_array_iterator_doc,
         "iterator(self)\n"
@@ -43,6 +152,128 @@ PyDoc_STRVAR(
         "----------\n"
         "A DictIterator which can read-out the contents of an AtomicDict");
 
+PyDoc_STRVAR(
+        dict_array_doc,
+        "An AtomicArray with the mapping protocol\n"
+        "\n"
+        "DictArray(memory_view, k64, k32, v64, v32, clearable=False, k16=0, v16=0, v8=0, dirty=False)\n"
+        "\n"
+        "d[key] installs key and returns the AtomicValue (or AtomicEntry) of its row.\n"
+        "d[key] = value installs key and stores value (a tuple for several value cells).\n"
+        "key in d tests for key without installing it.\n"
+        "len() scans every block and a truth test scans up to the first entry, so on a\n"
+        "large or empty table both take time proportional to its size.\n"
+        "A key is an integer, or a tuple with one integer per key cell.\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "See AtomicArray; cache mode is not supported");
+
+PyDoc_STRVAR(
+        set_array_doc,
+        "An AtomicArray of keys alone, with the set protocol\n"
+        "\n"
+        "SetArray(memory_view, k64, k32, v64, v32, clearable=False, k16=0, dirty=False)\n"
+        "\n"
+        "key in s tests for key without installing it.\n"
+        "len() scans every block and a truth test scans up to the first entry, so on a\n"
+        "large or empty table both take time proportional to its size.\n"
+        "A key is an integer, or a tuple with one integer per key cell.\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "See AtomicArray; cache mode is not supported");
+
+PyDoc_STRVAR(
+        set_array_add_doc,
+        "add(self, key)\n"
+        "--\n"
+        "\n"
+        "Installs key into the SetArray\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "key : A non-zero integer, or a tuple with one per key cell\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "True if this call installed key, False if it was already present");
+
+PyDoc_STRVAR(
+        direct_array_doc,
+        "A DirectArray type\n"
+        "\n"
+        "DirectArray(memory_view, bits, length)\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "memory_view : The MemoryView to use as shared storage\n"
+        "bits : The width of every cell; one of 8, 16, 32 or 64\n"
+        "length : The number of cells in the DirectArray");
+
+PyDoc_STRVAR(
+        direct_array_index_doc,
+        "index(self, offset)\n"
+        "--\n"
+        "\n"
+        "Retrieves the cell at offset in the DirectArray\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "offset : A non-negative integer less than the length of the DirectArray\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "The AtomicValue at this offset in the DirectArray");
+
+PyDoc_STRVAR(
+        direct_array_gather_doc,
+        "gather(self, indices, values)\n"
+        "--\n"
+        "\n"
+        "Atomically load every indexed cell into the matching element of values\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "indices : A contiguous buffer of 64-bit offsets into the DirectArray\n"
+        "values : A writable contiguous buffer of cell-sized integers, as long as indices\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "None");
+
+PyDoc_STRVAR(
+        direct_array_scatter_doc,
+        "scatter(self, indices, values)\n"
+        "--\n"
+        "\n"
+        "Atomically store every element of values to the matching indexed cell\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "indices : A contiguous buffer of 64-bit offsets into the DirectArray\n"
+        "values : A contiguous buffer of cell-sized integers, as long as indices\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "None");
+
+PyDoc_STRVAR(
+        direct_array_scatter_add_doc,
+        "scatter_add(self, indices, values)\n"
+        "--\n"
+        "\n"
+        "Atomically add every element of values to the matching indexed cell\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "indices : A contiguous buffer of 64-bit offsets into the DirectArray\n"
+        "values : A contiguous buffer of cell-sized integers, as long as indices\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "None");
+
 PyDoc_STRVAR(
         atomic_value_load_doc,
         "load(self)\n"
@@ -89,7 +320,7 @@ PyDoc_STRVAR(
         "add(self, arg)\n"
         "--\n"
         "\n"
-        "Adds arg to the AtomicValue\n"
+        "Adds arg to the AtomicValue; the result wraps around at the cell width\n"
         "\n"
         "Parameters\n"
         "----------\n"
@@ -104,7 +335,7 @@ PyDoc_STRVAR(
         "sub(self, arg)\n"
         "--\n"
         "\n"
-        "Subtracts arg from the AtomicValue\n"
+        "Subtracts arg from the AtomicValue; the result wraps around at the cell width\n"
         "\n"
         "Parameters\n"
         "----------\n"
@@ -160,6 +391,36 @@ PyDoc_STRVAR(
         "----------\n"
         "The value immediately preceding the effects of this function");
 
+PyDoc_STRVAR(
+        atomic_value_max_doc,
+        "max(self, arg)\n"
+        "--\n"
+        "\n"
+        "Replace the AtomicValue with arg if arg is larger\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "arg : Value to be compared with the AtomicValue\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "The value immediately preceding the effects of this function");
+
+PyDoc_STRVAR(
+        atomic_value_min_doc,
+        "min(self, arg)\n"
+        "--\n"
+        "\n"
+        "Replace the AtomicValue with arg if arg is smaller\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "arg : Value to be compared with the AtomicValue\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "The value immediately preceding the effects of this function");
+
 PyDoc_STRVAR(
         atomic_value_cas_doc,
         "cas(self, expected, desired)\n"
@@ -177,6 +438,56 @@ PyDoc_STRVAR(
         "----------\n"
         "The value immediately preceding the effects of this function");
 
+PyDoc_STRVAR(
+        atomic_entry_doc,
+        "An AtomicEntry type\n"
+        "\n"
+        "The values of a single key, which all share one cache-block.\n"
+        "entry[i] returns the AtomicValue of field i; wider fields come before narrower fields.");
+
+PyDoc_STRVAR(
+        atomic_entry_load_doc,
+        "load(self)\n"
+        "--\n"
+        "\n"
+        "Return the value of every field of the AtomicEntry\n"
+        "Each field is loaded atomically, but not all fields together.\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "A tuple with the value of each field");
+
+PyDoc_STRVAR(
+        atomic_entry_store_doc,
+        "store(self, *args)\n"
+        "--\n"
+        "\n"
+        "Store one argument into each field of the AtomicEntry\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "args : One value per field\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "None");
+
+PyDoc_STRVAR(
+        atomic_entry_add_doc,
+        "add(self, *args)\n"
+        "--\n"
+        "\n"
+        "Add one argument to each field of the AtomicEntry\n"
+        "Each field is updated atomically, but not all fields together.\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "args : One value per field to be added to it\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "A tuple of the field values immediately preceding the effects of this function");
+
 PyDoc_STRVAR(
         dict_iterator_key_doc,
         "key(self)\n"
@@ -211,6 +522,21 @@ PyDoc_STRVAR(
         "----------\n"
         "None");
 
+PyDoc_STRVAR(
+        read_layout_doc,
+        "read_layout(header)\n"
+        "--\n"
+        "\n"
+        "Decode the layout recorded in the header of a saved AtomicArray\n"
+        "\n"
+        "Parameters\n"
+        "----------\n"
+        "header : A buffer holding at least the first HEADER_BYTES of the shared memory\n"
+        "\n"
+        "Return value\n"
+        "----------\n"
+        "A tuple of (k64, k32, v64, v32, clearable, k16, v16, v8, cache, dirty, num_blocks)");
+
 PyDoc_STRVAR(
         get_pointer_doc,
         "get_pointer(capsule)\n"
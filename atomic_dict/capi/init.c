@@ -5,6 +5,7 @@
 
 PyMethodDef atomic_dict_capi_methods[] = {
     {"get_pointer", (PyCFunction) get_pointer, METH_FASTCALL, get_pointer_doc},
+    {"read_layout", (PyCFunction) read_layout, METH_FASTCALL, read_layout_doc},
     {NULL}  /* Sentinel */
 };
 
@@ -18,10 +19,29 @@ struct PyModuleDef atomic_dict_capi_module = {
 
 PyMethodDef atomic_array_methods[] = {
     {"index",    (PyCFunction) atomic_array_index,    METH_FASTCALL, atomic_array_index_doc},
+    {"clear",    (PyCFunction) atomic_array_clear,    METH_FASTCALL, atomic_array_clear_doc},
+    {"get",      (PyCFunction) atomic_array_get,      METH_FASTCALL, atomic_array_get_doc},
+    {"put",      (PyCFunction) atomic_array_put,      METH_FASTCALL, atomic_array_put_doc},
+    {"stats",    (PyCFunction) atomic_array_stats,    METH_FASTCALL, atomic_array_stats_doc},
+    {"rehash",   (PyCFunction) atomic_array_rehash,   METH_FASTCALL, atomic_array_rehash_doc},
+    {"recover",  (PyCFunction) atomic_array_recover,  METH_FASTCALL, atomic_array_recover_doc},
+    {"changed_since_and_reset", (PyCFunction) atomic_array_changes, METH_FASTCALL, atomic_array_changes_doc},
     {"iterator", (PyCFunction) atomic_array_iterator, METH_FASTCALL, atomic_array_iterator_doc},
     {NULL}  /* Sentinel */
 };
 
+PyMappingMethods atomic_array_mapping = {
+    .mp_length = (lenfunc) atomic_array_length,
+};
+
+PyNumberMethods atomic_array_number = {
+    .nb_bool = (inquiry) atomic_array_bool,
+};
+
+PySequenceMethods atomic_array_sequence = {
+    .sq_contains = (objobjproc) atomic_array_contains,
+};
+
 PyTypeObject AtomicArrayType = {
     .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
     .tp_name = "atomic_dict.capi.AtomicArray",
@@ -31,53 +51,136 @@ PyTypeObject AtomicArrayType = {
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
     .tp_new = PyType_GenericNew,
     .tp_init = (initproc) atomic_array_init,
+    .tp_as_number = &atomic_array_number,
+    .tp_as_mapping = &atomic_array_mapping,
+    .tp_as_sequence = &atomic_array_sequence,
+    .tp_iter = (getiterfunc) atomic_array_iter,
     .tp_methods = atomic_array_methods,
 };
 
-PyMethodDef atomic_value_64_methods[] = {
-    {"load",  (PyCFunction) atomic_value_64_load,  METH_FASTCALL, atomic_value_load_doc},
-    {"store", (PyCFunction) atomic_value_64_store, METH_FASTCALL, atomic_value_store_doc},
-    {"swap",  (PyCFunction) atomic_value_64_swap,  METH_FASTCALL, atomic_value_swap_doc},
-    {"add",   (PyCFunction) atomic_value_64_add,   METH_FASTCALL, atomic_value_add_doc},
-    {"sub",   (PyCFunction) atomic_value_64_sub,   METH_FASTCALL, atomic_value_sub_doc},
-    {"band",  (PyCFunction) atomic_value_64_band,  METH_FASTCALL, atomic_value_band_doc},
-    {"bor",   (PyCFunction) atomic_value_64_bor,   METH_FASTCALL, atomic_value_bor_doc},
-    {"bxor",  (PyCFunction) atomic_value_64_bxor,  METH_FASTCALL, atomic_value_bxor_doc},
-    {"cas",   (PyCFunction) atomic_value_64_cas,   METH_FASTCALL, atomic_value_cas_doc},
+PyMappingMethods dict_array_mapping = {
+    .mp_length = (lenfunc) atomic_array_length,
+    .mp_subscript = (binaryfunc) dict_array_subscript,
+    .mp_ass_subscript = (objobjargproc) dict_array_ass_subscript,
+};
+
+PySequenceMethods dict_array_sequence = {
+    .sq_contains = (objobjproc) atomic_array_contains,
+};
+
+PyTypeObject DictArrayType = {
+    .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "atomic_dict.capi.DictArray",
+    .tp_doc = dict_array_doc,
+    .tp_basicsize = sizeof(AtomicArray),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .tp_base = &AtomicArrayType,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc) dict_array_init,
+    .tp_as_number = &atomic_array_number,
+    .tp_as_mapping = &dict_array_mapping,
+    .tp_as_sequence = &dict_array_sequence,
+};
+
+PyMethodDef set_array_methods[] = {
+    {"add", (PyCFunction) set_array_add, METH_FASTCALL, set_array_add_doc},
     {NULL}  /* Sentinel */
 };
 
-PyTypeObject AtomicValue64Type = {
+PySequenceMethods set_array_sequence = {
+    .sq_length = (lenfunc) atomic_array_length,
+    .sq_contains = (objobjproc) atomic_array_contains,
+};
+
+PyTypeObject SetArrayType = {
     .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
-    .tp_name = "atomic_dict.capi.AtomicValue64",
-    .tp_basicsize = sizeof(AtomicValue64),
+    .tp_name = "atomic_dict.capi.SetArray",
+    .tp_doc = set_array_doc,
+    .tp_basicsize = sizeof(AtomicArray),
     .tp_itemsize = 0,
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .tp_base = &AtomicArrayType,
     .tp_new = PyType_GenericNew,
-    .tp_methods = atomic_value_64_methods,
-};
-
-PyMethodDef atomic_value_32_methods[] = {
-    {"load",  (PyCFunction) atomic_value_32_load,  METH_FASTCALL, atomic_value_load_doc},
-    {"store", (PyCFunction) atomic_value_32_store, METH_FASTCALL, atomic_value_store_doc},
-    {"swap",  (PyCFunction) atomic_value_32_swap,  METH_FASTCALL, atomic_value_swap_doc},
-    {"add",   (PyCFunction) atomic_value_32_add,   METH_FASTCALL, atomic_value_add_doc},
-    {"sub",   (PyCFunction) atomic_value_32_sub,   METH_FASTCALL, atomic_value_sub_doc},
-    {"band",  (PyCFunction) atomic_value_32_band,  METH_FASTCALL, atomic_value_band_doc},
-    {"bor",   (PyCFunction) atomic_value_32_bor,   METH_FASTCALL, atomic_value_bor_doc},
-    {"bxor",  (PyCFunction) atomic_value_32_bxor,  METH_FASTCALL, atomic_value_bxor_doc},
-    {"cas",   (PyCFunction) atomic_value_32_cas,   METH_FASTCALL, atomic_value_cas_doc},
+    .tp_init = (initproc) dict_array_init,
+    .tp_as_number = &atomic_array_number,
+    .tp_as_sequence = &set_array_sequence,
+    .tp_methods = set_array_methods,
+};
+
+#define ATOMIC_VALUE_TYPE(bits)                                                                          \
+PyMethodDef atomic_value_##bits##_methods[] = {                                                          \
+    {"load",  (PyCFunction) atomic_value_##bits##_load,  METH_FASTCALL, atomic_value_load_doc},          \
+    {"store", (PyCFunction) atomic_value_##bits##_store, METH_FASTCALL, atomic_value_store_doc},         \
+    {"swap",  (PyCFunction) atomic_value_##bits##_swap,  METH_FASTCALL, atomic_value_swap_doc},          \
+    {"add",   (PyCFunction) atomic_value_##bits##_add,   METH_FASTCALL, atomic_value_add_doc},           \
+    {"sub",   (PyCFunction) atomic_value_##bits##_sub,   METH_FASTCALL, atomic_value_sub_doc},           \
+    {"band",  (PyCFunction) atomic_value_##bits##_band,  METH_FASTCALL, atomic_value_band_doc},          \
+    {"bor",   (PyCFunction) atomic_value_##bits##_bor,   METH_FASTCALL, atomic_value_bor_doc},           \
+    {"bxor",  (PyCFunction) atomic_value_##bits##_bxor,  METH_FASTCALL, atomic_value_bxor_doc},          \
+    {"max",   (PyCFunction) atomic_value_##bits##_max,   METH_FASTCALL, atomic_value_max_doc},           \
+    {"min",   (PyCFunction) atomic_value_##bits##_min,   METH_FASTCALL, atomic_value_min_doc},           \
+    {"cas",   (PyCFunction) atomic_value_##bits##_cas,   METH_FASTCALL, atomic_value_cas_doc},           \
+    {NULL}  /* Sentinel */                                                                               \
+};                                                                                                       \
+                                                                                                         \
+PyTypeObject AtomicValue##bits##Type = {                                                                 \
+    .ob_base = PyVarObject_HEAD_INIT(NULL, 0)                                                            \
+    .tp_name = "atomic_dict.capi.AtomicValue" #bits,                                                     \
+    .tp_basicsize = sizeof(AtomicValue##bits),                                                           \
+    .tp_itemsize = 0,                                                                                    \
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,                                                \
+    .tp_new = PyType_GenericNew,                                                                         \
+    .tp_methods = atomic_value_##bits##_methods,                                                         \
+};
+
+ATOMIC_VALUE_TYPE(64)
+ATOMIC_VALUE_TYPE(32)
+ATOMIC_VALUE_TYPE(16)
+ATOMIC_VALUE_TYPE(8)
+
+PyMethodDef atomic_entry_methods[] = {
+    {"load",  (PyCFunction) atomic_entry_load,  METH_FASTCALL, atomic_entry_load_doc},
+    {"store", (PyCFunction) atomic_entry_store, METH_FASTCALL, atomic_entry_store_doc},
+    {"add",   (PyCFunction) atomic_entry_add,   METH_FASTCALL, atomic_entry_add_doc},
     {NULL}  /* Sentinel */
 };
 
-PyTypeObject AtomicValue32Type = {
+PySequenceMethods atomic_entry_sequence = {
+    .sq_length = (lenfunc) atomic_entry_length,
+    .sq_item = (ssizeargfunc) atomic_entry_field,
+};
+
+PyTypeObject AtomicEntryType = {
     .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
-    .tp_name = "atomic_dict.capi.AtomicValue32",
-    .tp_basicsize = sizeof(AtomicValue32),
+    .tp_name = "atomic_dict.capi.AtomicEntry",
+    .tp_doc = atomic_entry_doc,
+    .tp_basicsize = sizeof(AtomicEntry),
     .tp_itemsize = 0,
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
     .tp_new = PyType_GenericNew,
-    .tp_methods = atomic_value_32_methods,
+    .tp_as_sequence = &atomic_entry_sequence,
+    .tp_methods = atomic_entry_methods,
+};
+
+PyMethodDef direct_array_methods[] = {
+    {"index",       (PyCFunction) direct_array_index,       METH_FASTCALL, direct_array_index_doc},
+    {"gather",      (PyCFunction) direct_array_gather,      METH_FASTCALL, direct_array_gather_doc},
+    {"scatter",     (PyCFunction) direct_array_scatter,     METH_FASTCALL, direct_array_scatter_doc},
+    {"scatter_add", (PyCFunction) direct_array_scatter_add, METH_FASTCALL, direct_array_scatter_add_doc},
+    {NULL}  /* Sentinel */
+};
+
+PyTypeObject DirectArrayType = {
+    .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "atomic_dict.capi.DirectArray",
+    .tp_doc = direct_array_doc,
+    .tp_basicsize = sizeof(DirectArray),
+    .tp_itemsize = 0,
+    .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+    .tp_new = PyType_GenericNew,
+    .tp_init = (initproc) direct_array_init,
+    .tp_methods = direct_array_methods,
 };
 
 PyMethodDef dict_iterator_methods[] = {
@@ -94,14 +197,26 @@ PyTypeObject DictIteratorType = {
     .tp_itemsize = 0,
     .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
     .tp_new = PyType_GenericNew,
+    .tp_dealloc = (destructor) dict_iterator_dealloc,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc) dict_iterator_iternext,
     .tp_methods = dict_iterator_methods,
 };
 
 PyMODINIT_FUNC PyInit_capi(void) {
     PyObject *m;
 
-    if (PyType_Ready(&AtomicArrayType) < 0 || PyType_Ready(&AtomicValue64Type) < 0 ||
-        PyType_Ready(&AtomicValue32Type) < 0 || PyType_Ready(&DictIteratorType) < 0) {
+    if (PyType_Ready(&AtomicArrayType) < 0 || PyType_Ready(&DictArrayType) < 0 ||
+        PyType_Ready(&SetArrayType) < 0 || PyType_Ready(&AtomicValue64Type) < 0 ||
+        PyType_Ready(&AtomicValue32Type) < 0 || PyType_Ready(&AtomicValue16Type) < 0 ||
+        PyType_Ready(&AtomicValue8Type) < 0 || PyType_Ready(&AtomicEntryType) < 0 ||
+        PyType_Ready(&DirectArrayType) < 0 ||
+        PyType_Ready(&DictIteratorType) < 0) {
+        return NULL;
+    }
+
+    if (atomic_array_track_forks() != 0) {
+        PyErr_SetString(PyExc_RuntimeError, "atomic_dict could not register a fork handler");
         return NULL;
     }
 
@@ -110,11 +225,26 @@ PyMODINIT_FUNC PyInit_capi(void) {
         return NULL;
     }
 
+    if (PyModule_AddIntConstant(m, "HEADER_BYTES", ATOMIC_HEADER_BYTES) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
     if (PyModule_AddObjectRef(m, "AtomicArray", (PyObject *) &AtomicArrayType) < 0) {
         Py_DECREF(m);
         return NULL;
     }
 
+    if (PyModule_AddObjectRef(m, "DictArray", (PyObject *) &DictArrayType) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    if (PyModule_AddObjectRef(m, "SetArray", (PyObject *) &SetArrayType) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
     if (PyModule_AddObjectRef(m, "AtomicValue64", (PyObject *) &AtomicValue64Type) < 0) {
         Py_DECREF(m);
         return NULL;
@@ -125,6 +255,26 @@ PyMODINIT_FUNC PyInit_capi(void) {
         return NULL;
     }
 
+    if (PyModule_AddObjectRef(m, "AtomicValue16", (PyObject *) &AtomicValue16Type) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    if (PyModule_AddObjectRef(m, "AtomicValue8", (PyObject *) &AtomicValue8Type) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    if (PyModule_AddObjectRef(m, "AtomicEntry", (PyObject *) &AtomicEntryType) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    if (PyModule_AddObjectRef(m, "DirectArray", (PyObject *) &DirectArrayType) < 0) {
+        Py_DECREF(m);
+        return NULL;
+    }
+
     if (PyModule_AddObjectRef(m, "DictIterator", (PyObject *) &DictIteratorType) < 0) {
         Py_DECREF(m);
         return NULL;
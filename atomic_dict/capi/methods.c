@@ -1,19 +1,46 @@
 #include "methods.h"
+#include "probes.h"
 
+#include <pthread.h>
+
+extern PyTypeObject AtomicArrayType;
 extern PyTypeObject DictIteratorType;
 extern PyTypeObject AtomicValue64Type;
 extern PyTypeObject AtomicValue32Type;
+extern PyTypeObject AtomicValue16Type;
+extern PyTypeObject AtomicValue8Type;
+extern PyTypeObject AtomicEntryType;
+
+// Counts the forks which led to this process, without a getpid() call on every lookup
+static atomic_uint forks;
+
+static void count_fork(void) {
+    atomic_fetch_add(&forks, 1);
+}
+
+int atomic_array_track_forks(void) {
+    return pthread_atfork(0, 0, count_fork);
+}
 
 int atomic_array_init(AtomicArray *self, PyObject *args, PyObject *kwds) {
+    static char *kwlist[] = {"memory_view", "k64", "k32", "v64", "v32", "clearable", "k16", "v16", "v8", "cache", "dirty", NULL};
     PyObject *memory_view;
     Py_buffer *buffer;
+    Py_ssize_t num_blocks;
     int k64, k32, v64, v32;
-
-    if (!PyArg_ParseTuple(args, "Oiiii|", &memory_view, &k64, &k32, &v64, &v32)) {
+    int k16 = 0, v16 = 0, v8 = 0;
+    int clearable = 0;
+    int cache = 0;
+    int dirty = 0;
+    int reserved;
+    int row_bytes;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "Oiiii|piiipp", kwlist,
+                                     &memory_view, &k64, &k32, &v64, &v32, &clearable, &k16, &v16, &v8, &cache, &dirty)) {
         return -1;
     }
 
-    if (sizeof(AtomicCacheBlock) != 64) {
+    if (sizeof(AtomicCacheBlock) != 64 || sizeof(AtomicHeader) != ATOMIC_HEADER_BYTES) {
        PyErr_SetString(PyExc_ValueError, "AtomicArray AtomicCacheBlock is not 64 bytes");
        return -1;
     }
@@ -22,43 +49,80 @@ int atomic_array_init(AtomicArray *self, PyObject *args, PyObject *kwds) {
     if (!buffer)
         return -1;
 
-    if ((buffer->len & (buffer->len - 1)) != 0) {
-        PyErr_SetString(PyExc_ValueError, "AtomicArray buffer must be power-of-two sized");
+    if (buffer->len % 64 != 0 || buffer->len < ATOMIC_HEADER_BYTES + 64) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray buffer must hold a header and at least one cache block");
         return -1;
     }
 
-    if (buffer->len < 64) {
-        PyErr_SetString(PyExc_ValueError, "AtomicArray buffer must be at least one cache block");
-        return -1;
+    // The blocks fill the buffer, save for the header and the dirty bitmap
+    for (num_blocks = 1; ATOMIC_HEADER_BYTES + 64 * num_blocks + (dirty ? ATOMIC_DIRTY_BYTES(num_blocks) : 0) < buffer->len;) {
+        num_blocks *= 2;
     }
 
-    if (k64 < 0 || k32 < 0 || v64 < 0 || v32 < 0) {
-        PyErr_SetString(PyExc_ValueError, "AtomicArray key and value cells must be non-negative");
+    if (ATOMIC_HEADER_BYTES + 64 * num_blocks + (dirty ? ATOMIC_DIRTY_BYTES(num_blocks) : 0) != buffer->len) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray buffer must have a power-of-two number of cache blocks");
         return -1;
     }
 
-    if (k64 == 0 && k32 == 0) {
-        PyErr_SetString(PyExc_ValueError, "AtomicArray must have at least one key cell");
+    if (k64 < 0 || k32 < 0 || k16 < 0 || v64 < 0 || v32 < 0 || v16 < 0 || v8 < 0) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray key and value cells must be non-negative");
         return -1;
     }
 
-    if (v64 + v32 > 1) {
-        PyErr_SetString(PyExc_ValueError, "AtomicArray can only store one atomic value per key");
+    if (k64 == 0 && k32 == 0 && k16 == 0) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray must have at least one key cell");
         return -1;
     }
 
-    if ((k64 + v64) * 8 + (k32 + v32) * 4 > 64) {
+    // The generation tag and clock word each take a 32-bit cell from the end of the block
+    reserved = 4 * (clearable + cache);
+    row_bytes = (k64 + v64) * 8 + (k32 + v32) * 4 + (k16 + v16) * 2 + v8;
+    if (row_bytes + reserved > 64) {
         PyErr_SetString(PyExc_ValueError, "AtomicArray single entry exceeds a cache-block");
         return -1;
     }
 
-    self->blocks = (AtomicCacheBlock *)buffer->buf;
-    self->num_blocks = buffer->len / 64;
+    self->header = (AtomicHeader *)buffer->buf;
+    self->blocks = (AtomicCacheBlock *)((char *)buffer->buf + ATOMIC_HEADER_BYTES);
+    self->dirty = dirty ? (atomic_dict64_t *)(self->blocks + num_blocks) : 0;
+    self->num_blocks = num_blocks;
     self->k64 = k64;
     self->k32 = k32;
+    self->k16 = k16;
     self->v64 = v64;
     self->v32 = v32;
-    self->rows = 64 / ((k64 + v64) * 8 + (k32 + v32) * 4);
+    self->v16 = v16;
+    self->v8 = v8;
+    self->clearable = clearable;
+    self->cache = cache;
+    self->clock_cell = ATOMIC_GENERATION_CELL - clearable;
+    self->forks = atomic_load(&forks);
+    atomic_store(&self->hits, 0);
+    atomic_store(&self->misses, 0);
+    atomic_store(&self->evictions, 0);
+    self->rows = (64 - reserved) / row_bytes;
+
+    // There is only room for so many reference bits in the clock word
+    if (cache && self->rows > ATOMIC_CLOCK_ROWS) self->rows = ATOMIC_CLOCK_ROWS;
+
+    // Each cell width occupies its own region of the block, widest first
+    self->o32 = self->rows * (k64 + v64) * 2;
+    self->o16 = (self->o32 + self->rows * (k32 + v32)) * 2;
+    self->o8  = (self->o16 + self->rows * (k16 + v16)) * 2;
+
+    // Describe the layout in the header, so that a saved copy can be loaded again
+    self->header->format = ATOMIC_FORMAT;
+    self->header->num_blocks = num_blocks;
+    self->header->cells[0] = k64;
+    self->header->cells[1] = k32;
+    self->header->cells[2] = k16;
+    self->header->cells[3] = v64;
+    self->header->cells[4] = v32;
+    self->header->cells[5] = v16;
+    self->header->cells[6] = v8;
+    self->header->clearable = clearable;
+    self->header->cache = cache;
+    self->header->dirty = dirty;
 
     return 0;
 }
@@ -74,6 +138,20 @@ static uint64_t key_hash(uint64_t key) {
     return key;
 }
 
+// Convert an argument for a cell of the given width.
+// Returns 0 (with an exception set) if it is not an integer which fits the cell.
+static int cell_from_py(PyObject *arg, int bits, uint64_t *out) {
+    *out = PyLong_AsUnsignedLongLong(arg);
+    if (*out == (uint64_t)-1 && PyErr_Occurred()) return 0;
+
+    if (bits < 64 && (*out >> bits) != 0) {
+        PyErr_Format(PyExc_OverflowError, "%llu does not fit in a cell of %d bits", (unsigned long long)*out, bits);
+        return 0;
+    }
+
+    return 1;
+}
+
 #define STR_HELPER(x) #x
 #define STR(x) STR_HELPER(x)
 #define CHECK_ARGN(fn, n) if (nargs != n) {                                               \
@@ -81,103 +159,350 @@ static uint64_t key_hash(uint64_t key) {
     return 0;                                                                             \
 }
 
-PyObject *atomic_array_index(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
-    AtomicCacheBlock key;
-    uint64_t         kv;
-    uint64_t         hash;
+static uint32_t atomic_array_generation(AtomicArray *self) {
+    if (!self->clearable) return 0;
+    return atomic_load(&self->header->generation) & ATOMIC_GENERATION_MASK;
+}
+
+static int block_is_live(AtomicCacheBlock *block, uint32_t generation) {
+    return atomic_load(&block->a32[ATOMIC_GENERATION_CELL]) == generation;
+}
+
+// Record that a block changed. Call it after the change, so a scan which resets
+// the bit either sees the change or leaves the bit set for the next scan.
+static void dirty_mark(AtomicDirty *dirty) {
+    // Skip the write when the bit is already set, to keep the line shared
+    if (dirty->word && !(atomic_load(dirty->word) & dirty->bit)) {
+        atomic_fetch_or_explicit(dirty->word, dirty->bit, memory_order_release);
+    }
+}
+
+static void atomic_array_dirty(AtomicArray *self, AtomicCacheBlock *block, AtomicDirty *dirty) {
+    Py_ssize_t index = block - self->blocks;
+
+    dirty->word = self->dirty ? self->dirty + index / 64 : 0;
+    dirty->bit = UINT64_C(1) << (index % 64);
+}
+
+// Bring a block into the caller's generation, wiping it if it is stale.
+// Returns 0 if the block already belongs to a newer generation, or -1 if
+// another process started wiping it and never finished.
+static int block_refresh(AtomicCacheBlock *block, uint32_t generation) {
+    atomic_dict32_t *tag = &block->a32[ATOMIC_GENERATION_CELL];
+    uint32_t         seen = atomic_load(tag);
+    int              cell;
+    int              retries = 0;
+
+    while (seen != generation) {
+        if (seen & ATOMIC_GENERATION_BUSY) {
+            // Another process is wiping this block; that is only a few stores, unless it was killed
+            if (++retries >= ATOMIC_CLOCK_SPINS) break;
+            seen = atomic_load(tag);
+        } else if (((generation - seen) & ATOMIC_GENERATION_MASK) > ATOMIC_GENERATION_MASK / 2) {
+            break;
+        } else if (atomic_compare_exchange_strong(tag, &seen, generation | ATOMIC_GENERATION_BUSY)) {
+            for (cell = 0; cell < ATOMIC_GENERATION_CELL; ++cell) {
+                atomic_store(&block->a32[cell], 0);
+            }
+            atomic_store(tag, generation);
+            seen = generation;
+        } else {
+            ++retries;
+        }
+    }
+
+    if (retries) ATOMIC_PROBE2(cas_retry, tag, retries);
+    if (seen & ATOMIC_GENERATION_BUSY) return -1;
+    return seen == generation;
+}
+
+// Find or install key, returning the block and row that hold it.
+// Returns 0 if the key does not fit, or -1 if a block on its path stayed
+// mid-wipe; this does not need the GIL.
+static int atomic_array_claim(AtomicArray *self, const AtomicCacheBlock *key, uint64_t hash,
+                              AtomicCacheBlock **out_block, int *out_row, int *out_first) {
+    uint32_t         generation;
     int              ki;
     int              row;
-    int              match = 0;
+    int              match;
     int              first = 0;
+    int              stale;
+    int              fresh;
     atomic_dict64_t  e64;
     atomic_dict32_t  e32;
+    atomic_dict16_t  e16;
     Py_ssize_t       index;
     Py_ssize_t       stride;
     Py_ssize_t       attempts;
-    AtomicValue64   *v64 = 0;
-    AtomicValue32   *v32 = 0;
+    int              n64 = self->k64 + self->v64;
+    int              n32 = self->k32 + self->v32;
+    int              n16 = self->k16 + self->v16;
+    int              q32 = 2 * self->k64;
+    int              q16 = 4 * self->k64 + 2 * self->k32;
+
+    do {
+        generation = atomic_array_generation(self);
+        stale = 0;
+
+        index = hash & (self->num_blocks - 1);
+        stride = ((hash >> 32) & (self->num_blocks - 1)) | 1;
+
+        for (attempts = 0; attempts < self->num_blocks; ++attempts) {
+            AtomicCacheBlock *block = self->blocks + index;
+
+            fresh = self->clearable ? block_refresh(block, generation) : 1;
+            if (fresh < 0) return -1;
+
+            // A clear() raced with us; start over in the new generation
+            if (!fresh) {
+                ATOMIC_PROBE2(cas_retry, &self->header->generation, 1);
+                stale = 1;
+                break;
+            }
+
+            for (row = 0; row < self->rows; ++row) {
+                atomic_dict64_t *a64 = &block->a64[row * n64];
+                atomic_dict32_t *a32 = &block->a32[self->o32 + row * n32];
+                atomic_dict16_t *a16 = &block->a16[self->o16 + row * n16];
+                match = 1;
+
+                // The row is ours if we filled its final key cell
+                for (ki = 0; match && ki < self->k64; ++ki) {
+                    e64 = 0;
+                    atomic_compare_exchange_strong(a64 + ki, &e64, key->a64[ki]);
+                    match = e64 == 0 || e64 == key->a64[ki];
+                    first = ki + 1 == self->k64 && e64 == 0 && self->k32 == 0 && self->k16 == 0;
+                }
+
+                for (ki = 0; match && ki < self->k32; ++ki) {
+                    e32 = 0;
+                    atomic_compare_exchange_strong(a32 + ki, &e32, key->a32[ki + q32]);
+                    match = e32 == 0 || e32 == key->a32[ki + q32];
+                    first = ki + 1 == self->k32 && e32 == 0 && self->k16 == 0;
+                }
+
+                for (ki = 0; match && ki < self->k16; ++ki) {
+                    e16 = 0;
+                    atomic_compare_exchange_strong(a16 + ki, &e16, key->a16[ki + q16]);
+                    match = e16 == 0 || e16 == key->a16[ki + q16];
+                    first = ki + 1 == self->k16 && e16 == 0;
+                }
+
+                if (match) {
+                    if (first) {
+                        AtomicDirty dirty;
+                        atomic_array_dirty(self, block, &dirty);
+                        dirty_mark(&dirty);
+                        ATOMIC_PROBE2(insert, hash, attempts + 1);
+                    }
+                    ATOMIC_PROBE2(probe, attempts + 1, !first);
+                    *out_block = block;
+                    *out_row = row;
+                    *out_first = first;
+                    return 1;
+                }
+            }
+
+            index = (index + stride) & (self->num_blocks - 1);
+        }
+    } while (stale);
+
+    ATOMIC_PROBE1(capacity_exceeded, self->num_blocks);
+    return 0;
+}
+
+// Set the exception for a failed atomic_array_claim
+static void atomic_array_claim_error(int claimed) {
+    if (claimed < 0) {
+        PyErr_SetString(PyExc_TimeoutError, "AtomicArray block was left mid-wipe by a dead process; save and load the table");
+    } else {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray capacity exceeded");
+    }
+}
+
+// As atomic_array_claim, but with an exception set if the key does not fit
+static int atomic_array_probe(AtomicArray *self, const AtomicCacheBlock *key, uint64_t hash,
+                              AtomicCacheBlock **out_block, int *out_row, int *out_first) {
+    int claimed = atomic_array_claim(self, key, hash, out_block, out_row, out_first);
+
+    if (claimed > 0) return 1;
+
+    atomic_array_claim_error(claimed);
+    return 0;
+}
+
+// Point entry at the value cells of a row
+static void atomic_array_row(AtomicArray *self, AtomicCacheBlock *block, int row, AtomicEntry *entry) {
+    entry->v64 = &block->a64[row * (self->k64 + self->v64) + self->k64];
+    entry->v32 = &block->a32[self->o32 + row * (self->k32 + self->v32) + self->k32];
+    entry->v16 = &block->a16[self->o16 + row * (self->k16 + self->v16) + self->k16];
+    entry->v8  = &block->a8[self->o8 + row * self->v8];
+    entry->n64 = self->v64;
+    entry->n32 = self->v32;
+    entry->n16 = self->v16;
+    entry->n8  = self->v8;
+    atomic_array_dirty(self, block, &entry->dirty);
+}
 
-    CHECK_ARGN("AtomicArray.index", self->k64 + self->k32);
+// Hash the key cells, which are packed into key the same way as into the first row of a block
+static uint64_t atomic_array_hash(AtomicArray *self, const AtomicCacheBlock *key) {
+    uint64_t hash = 0;
+    int      ki;
 
-    hash = 0;
+    for (ki = 0; ki < self->k64; ++ki) hash = key_hash(hash ^ key->a64[ki]);
+    for (ki = 0; ki < self->k32; ++ki) hash = key_hash(hash ^ key->a32[ki + 2 * self->k64]);
+    for (ki = 0; ki < self->k16; ++ki) hash = key_hash(hash ^ key->a16[ki + 4 * self->k64 + 2 * self->k32]);
 
+    return hash;
+}
+
+// Parse the key cells from args, returning 0 (with an exception set) if they are invalid
+static int atomic_array_key(AtomicArray *self, const char *fn, PyObject * const *args,
+                            AtomicCacheBlock *key, uint64_t *hash) {
+    uint64_t kv;
+    int      ki;
+
+    // A key too wide for its cell would alias a narrower key, or look like an empty row
     for (ki = 0; ki < self->k64; ++ki) {
-      kv = PyLong_AsUnsignedLongLong(args[ki]);
-      if (!kv) {
-        PyErr_SetString(PyExc_ValueError, "AtomicArray.index requires key arguments to be non-zero");
-        return 0;
-      }
-      key.a64[ki] = kv;
-      hash = key_hash(hash ^ kv);
+      if (!cell_from_py(args[ki], 64, &kv)) return 0;
+      if (!kv) goto zero;
+      key->a64[ki] = kv;
     }
 
     for (ki = 0; ki < self->k32; ++ki) {
-      kv = PyLong_AsUnsignedLong(args[ki + self->k64]);
-      if (!kv) {
-        PyErr_SetString(PyExc_ValueError, "AtomicArray.index requires key arguments to be non-zero");
-        return 0;
-      }
-      key.a32[ki + 2 * self->k64] = kv;
-      hash = key_hash(hash ^ kv);
-    }
-    
-    if (self->v64) {
-        v64 = PyObject_New(AtomicValue64, &AtomicValue64Type);
-        if (!v64) return 0;
+      if (!cell_from_py(args[ki + self->k64], 32, &kv)) return 0;
+      if (!kv) goto zero;
+      key->a32[ki + 2 * self->k64] = kv;
     }
 
-    if (self->v32) {
-        v32 = PyObject_New(AtomicValue32, &AtomicValue32Type);
-        if (!v32) return 0;
+    for (ki = 0; ki < self->k16; ++ki) {
+      if (!cell_from_py(args[ki + self->k64 + self->k32], 16, &kv)) return 0;
+      if (!kv) goto zero;
+      key->a16[ki + 4 * self->k64 + 2 * self->k32] = kv;
     }
 
-    index = hash & (self->num_blocks - 1);
-    stride = ((hash >> 32) & (self->num_blocks - 1)) | 1;
+    *hash = atomic_array_hash(self, key);
+    return 1;
 
-    for (attempts = 0; !match && attempts < self->num_blocks; ++attempts) {
-        AtomicCacheBlock *block = self->blocks + index;
-        atomic_dict64_t *a64 = &block->a64[0];
-        atomic_dict32_t *a32 = &block->a32[2 * self->rows * (self->k64 + self->v64)];
+zero:
+    PyErr_Format(PyExc_ValueError, "%s requires key arguments to be non-zero", fn);
+    return 0;
+}
 
-        for (row = 0; !match && row < self->rows; ++row) {
-            match = 1;
+// Parse a key given as a single object: an integer, or a tuple with one integer per key cell
+static int atomic_array_key_object(AtomicArray *self, const char *fn, PyObject *obj,
+                                   AtomicCacheBlock *key, uint64_t *hash) {
+    int keys = self->k64 + self->k32 + self->k16;
 
-            for (ki = 0; match && ki < self->k64; ++ki) {
-                e64 = 0;
-                atomic_compare_exchange_strong(a64 + ki, &e64, key.a64[ki]);
-                match = e64 == 0 || e64 == key.a64[ki];
-                first = ki + 1 == self->k64 && e64 == 0 && self->k32 == 0;
-            }
+    if (PyTuple_Check(obj) && PyTuple_GET_SIZE(obj) == keys) {
+        return atomic_array_key(self, fn, PySequence_Fast_ITEMS(obj), key, hash);
+    }
 
-            for (ki = 0; match && ki < self->k32; ++ki) {
-                e32 = 0;
-                atomic_compare_exchange_strong(a32 + ki, &e32, key.a32[ki + 2 * self->k64]);
-                match = e32 == 0 || e32 == key.a32[ki + 2 * self->k32];
-                first = ki + 1 == self->k32 && e32 == 0;
-            }
+    if (keys == 1 && !PyTuple_Check(obj)) {
+        return atomic_array_key(self, fn, &obj, key, hash);
+    }
 
-            if (v64) { v64->val = a64 + self->k64; }
-            if (v32) { v32->val = a32 + self->k32; }
+    PyErr_Format(PyExc_TypeError, "%s expected a key of %d cells", fn, keys);
+    return 0;
+}
 
-            a64 += self->k64 + self->v64;
-            a32 += self->k32 + self->v32;
-        }
+// Install key, returning a handle to its value cells (or whether it is new, if there are none)
+static PyObject *atomic_array_lookup(AtomicArray *self, const AtomicCacheBlock *key, uint64_t hash) {
+    AtomicCacheBlock *block;
+    AtomicEntry       cells;
+    PyTypeObject     *type = 0;
+    PyObject         *out = 0;
+    int               row;
+    int               first;
+
+    // Entries with several values share one handle for the whole row
+    if (self->v64 + self->v32 + self->v16 + self->v8 > 1) {
+        type = &AtomicEntryType;
+    } else if (self->v64) {
+        type = &AtomicValue64Type;
+    } else if (self->v32) {
+        type = &AtomicValue32Type;
+    } else if (self->v16) {
+        type = &AtomicValue16Type;
+    } else if (self->v8) {
+        type = &AtomicValue8Type;
+    }
 
-        index = (index + stride) & (self->num_blocks - 1);
+    if (type) {
+        out = PyObject_New(PyObject, type);
+        if (!out) return 0;
     }
 
-    if (attempts == self->num_blocks) {
-        if (v64) Py_DECREF(v64);
-        if (v32) Py_DECREF(v32);
-        PyErr_SetString(PyExc_ValueError, "AtomicArray capacity exceeded");
+    if (!atomic_array_probe(self, key, hash, &block, &row, &first)) {
+        Py_XDECREF(out);
         return 0;
     }
 
-    if (v64) return (PyObject*)v64;
-    if (v32) return (PyObject*)v32;
+    if (type == &AtomicEntryType) {
+        atomic_array_row(self, block, row, (AtomicEntry*)out);
+        return out;
+    }
+
+    atomic_array_row(self, block, row, &cells);
+
+    if (type == &AtomicValue64Type) {
+        ((AtomicValue64*)out)->val = cells.v64;
+        ((AtomicValue64*)out)->dirty = cells.dirty;
+        return out;
+    }
+
+    if (type == &AtomicValue32Type) {
+        ((AtomicValue32*)out)->val = cells.v32;
+        ((AtomicValue32*)out)->dirty = cells.dirty;
+        return out;
+    }
+
+    if (type == &AtomicValue16Type) {
+        ((AtomicValue16*)out)->val = cells.v16;
+        ((AtomicValue16*)out)->dirty = cells.dirty;
+        return out;
+    }
+
+    if (type == &AtomicValue8Type) {
+        ((AtomicValue8*)out)->val = cells.v8;
+        ((AtomicValue8*)out)->dirty = cells.dirty;
+        return out;
+    }
+
     return PyBool_FromLong(first);
 }
 
+PyObject *atomic_array_index(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    AtomicCacheBlock key;
+    uint64_t         hash;
+
+    CHECK_ARGN("AtomicArray.index", self->k64 + self->k32 + self->k16);
+
+    // A handle into a row could outlive the row's eviction
+    if (self->cache) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray.index is not available in cache mode; use get and put");
+        return 0;
+    }
+
+    if (!atomic_array_key(self, "AtomicArray.index", args, &key, &hash)) return 0;
+
+    return atomic_array_lookup(self, &key, hash);
+}
+
+PyObject *atomic_array_clear(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    CHECK_ARGN("AtomicArray.clear", 0);
+
+    if (!self->clearable) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray was not created clearable");
+        return 0;
+    }
+
+    // Every block now belongs to an older generation; probes wipe them lazily
+    atomic_fetch_add(&self->header->generation, 1);
+
+    Py_RETURN_NONE;
+}
+
 DictIterator *atomic_array_iterator(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
     DictIterator *out;
 
@@ -185,6 +510,7 @@ DictIterator *atomic_array_iterator(AtomicArray *self, PyObject * const *args, P
 
     out = PyObject_New(DictIterator, &DictIteratorType);
     if (out) {
+        Py_INCREF(self);
         out->array = self;
         out->offset = 0;
     }
@@ -193,195 +519,1301 @@ DictIterator *atomic_array_iterator(AtomicArray *self, PyObject * const *args, P
 }
 
 
-PyObject *atomic_value_64_load(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue64.load", 0);
-    return PyLong_FromUnsignedLongLong(atomic_load(self->val));
+// Every operand must fit in the cell, or OverflowError is raised rather than storing a truncated value.
+// The results of add and sub wrap around modulo 2**bits, as the hardware does.
+#define ATOMIC_VALUE_METHODS(bits, to_py)                                                                     \
+PyObject *atomic_value_##bits##_load(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {     \
+    CHECK_ARGN("AtomicValue" #bits ".load", 0);                                                               \
+    return to_py(atomic_load(self->val));                                                                     \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_store(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {    \
+    CHECK_ARGN("AtomicValue" #bits ".store", 1);                                                              \
+    uint64_t value;                                                                                           \
+    if (!cell_from_py(args[0], bits, &value)) return 0;                                                       \
+    atomic_store(self->val, value);                                                                           \
+    dirty_mark(&self->dirty);                                                                                 \
+    Py_RETURN_NONE;                                                                                           \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_swap(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {     \
+    CHECK_ARGN("AtomicValue" #bits ".swap", 1);                                                               \
+    uint64_t value;                                                                                           \
+    if (!cell_from_py(args[0], bits, &value)) return 0;                                                       \
+    uint_least##bits##_t seen = atomic_exchange(self->val, value);                                            \
+    dirty_mark(&self->dirty);                                                                                 \
+    return to_py(seen);                                                                                       \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_add(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {      \
+    CHECK_ARGN("AtomicValue" #bits ".add", 1);                                                                \
+    uint64_t value;                                                                                           \
+    if (!cell_from_py(args[0], bits, &value)) return 0;                                                       \
+    uint_least##bits##_t seen = atomic_fetch_add(self->val, value);                                           \
+    dirty_mark(&self->dirty);                                                                                 \
+    return to_py(seen);                                                                                       \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_sub(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {      \
+    CHECK_ARGN("AtomicValue" #bits ".sub", 1);                                                                \
+    uint64_t value;                                                                                           \
+    if (!cell_from_py(args[0], bits, &value)) return 0;                                                       \
+    uint_least##bits##_t seen = atomic_fetch_sub(self->val, value);                                           \
+    dirty_mark(&self->dirty);                                                                                 \
+    return to_py(seen);                                                                                       \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_band(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {     \
+    CHECK_ARGN("AtomicValue" #bits ".band", 1);                                                               \
+    uint64_t value;                                                                                           \
+    if (!cell_from_py(args[0], bits, &value)) return 0;                                                       \
+    uint_least##bits##_t seen = atomic_fetch_and(self->val, value);                                           \
+    dirty_mark(&self->dirty);                                                                                 \
+    return to_py(seen);                                                                                       \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_bor(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {      \
+    CHECK_ARGN("AtomicValue" #bits ".bor", 1);                                                                \
+    uint64_t value;                                                                                           \
+    if (!cell_from_py(args[0], bits, &value)) return 0;                                                       \
+    uint_least##bits##_t seen = atomic_fetch_or(self->val, value);                                            \
+    dirty_mark(&self->dirty);                                                                                 \
+    return to_py(seen);                                                                                       \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_bxor(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {     \
+    CHECK_ARGN("AtomicValue" #bits ".bxor", 1);                                                               \
+    uint64_t value;                                                                                           \
+    if (!cell_from_py(args[0], bits, &value)) return 0;                                                       \
+    uint_least##bits##_t seen = atomic_fetch_xor(self->val, value);                                           \
+    dirty_mark(&self->dirty);                                                                                 \
+    return to_py(seen);                                                                                       \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_max(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {      \
+    CHECK_ARGN("AtomicValue" #bits ".max", 1);                                                                \
+    uint64_t value;                                                                                           \
+    if (!cell_from_py(args[0], bits, &value)) return 0;                                                       \
+    uint_least##bits##_t desired = value;                                                                     \
+    uint_least##bits##_t seen = atomic_load(self->val);                                                       \
+    int retries = 0;                                                                                          \
+    while (seen < desired && !atomic_compare_exchange_weak(self->val, &seen, desired)) ++retries;             \
+    if (retries) ATOMIC_PROBE2(cas_retry, self->val, retries);                                                \
+    if (seen < desired) dirty_mark(&self->dirty);                                                             \
+    return to_py(seen);                                                                                       \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_min(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {      \
+    CHECK_ARGN("AtomicValue" #bits ".min", 1);                                                                \
+    uint64_t value;                                                                                           \
+    if (!cell_from_py(args[0], bits, &value)) return 0;                                                       \
+    uint_least##bits##_t desired = value;                                                                     \
+    uint_least##bits##_t seen = atomic_load(self->val);                                                       \
+    int retries = 0;                                                                                          \
+    while (seen > desired && !atomic_compare_exchange_weak(self->val, &seen, desired)) ++retries;             \
+    if (retries) ATOMIC_PROBE2(cas_retry, self->val, retries);                                                \
+    if (seen > desired) dirty_mark(&self->dirty);                                                             \
+    return to_py(seen);                                                                                       \
+}                                                                                                             \
+                                                                                                              \
+PyObject *atomic_value_##bits##_cas(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs) {      \
+    CHECK_ARGN("AtomicValue" #bits ".cas", 2);                                                                \
+    uint64_t old_value, new_value;                                                                            \
+    if (!cell_from_py(args[0], bits, &old_value) || !cell_from_py(args[1], bits, &new_value)) return 0;       \
+    uint_least##bits##_t expected = old_value;                                                                \
+    if (atomic_compare_exchange_strong(self->val, &expected, new_value)) dirty_mark(&self->dirty);            \
+    return to_py(expected);                                                                                   \
 }
 
-PyObject *atomic_value_64_store(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue64.store", 1);
-    atomic_store(self->val, PyLong_AsUnsignedLongLong(args[0]));
-    Py_RETURN_NONE;
-}
+ATOMIC_VALUE_METHODS(64, PyLong_FromUnsignedLongLong)
+ATOMIC_VALUE_METHODS(32, PyLong_FromUnsignedLong)
+ATOMIC_VALUE_METHODS(16, PyLong_FromUnsignedLong)
+ATOMIC_VALUE_METHODS(8, PyLong_FromUnsignedLong)
 
-PyObject *atomic_value_64_swap(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue64.swap", 1);
-    return PyLong_FromUnsignedLongLong(atomic_exchange(self->val, PyLong_AsUnsignedLongLong(args[0])));
-}
 
-PyObject *atomic_value_64_add(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue64.add", 1);
-    return PyLong_FromUnsignedLongLong(atomic_fetch_add(self->val, PyLong_AsUnsignedLongLong(args[0])));
+// The most fields an entry can have; a row of 8-bit values filling the block
+#define ATOMIC_ENTRY_FIELDS 64
+
+// Apply op to every cell of an entry, widest first, with field counting across widths
+#define ATOMIC_ENTRY_EACH(op) {                                                        \
+        int field = 0, cell;                                                           \
+        for (cell = 0; cell < self->n64; ++cell, ++field) op(self->v64 + cell);        \
+        for (cell = 0; cell < self->n32; ++cell, ++field) op(self->v32 + cell);        \
+        for (cell = 0; cell < self->n16; ++cell, ++field) op(self->v16 + cell);        \
+        for (cell = 0; cell < self->n8;  ++cell, ++field) op(self->v8  + cell);        \
+    }
+
+Py_ssize_t atomic_entry_length(AtomicEntry *self) {
+    return self->n64 + self->n32 + self->n16 + self->n8;
 }
 
-PyObject *atomic_value_64_sub(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue64.sub", 1);
-    return PyLong_FromUnsignedLongLong(atomic_fetch_sub(self->val, PyLong_AsUnsignedLongLong(args[0])));
+PyObject *atomic_entry_field(AtomicEntry *self, Py_ssize_t field) {
+#define ATOMIC_ENTRY_FIELD(bits) {                                                     \
+        if (field >= 0 && field < self->n##bits) {                                     \
+            AtomicValue##bits *out = PyObject_New(AtomicValue##bits, &AtomicValue##bits##Type); \
+            if (out) {                                                                 \
+                out->val = self->v##bits + field;                                      \
+                out->dirty = self->dirty;                                              \
+            }                                                                          \
+            return (PyObject*)out;                                                     \
+        }                                                                              \
+        field -= self->n##bits;                                                        \
+    }
+
+    ATOMIC_ENTRY_FIELD(64)
+    ATOMIC_ENTRY_FIELD(32)
+    ATOMIC_ENTRY_FIELD(16)
+    ATOMIC_ENTRY_FIELD(8)
+
+#undef ATOMIC_ENTRY_FIELD
+
+    PyErr_SetString(PyExc_IndexError, "AtomicEntry field out of range");
+    return 0;
 }
 
-PyObject *atomic_value_64_band(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue64.band", 1);
-    return PyLong_FromUnsignedLongLong(atomic_fetch_and(self->val, PyLong_AsUnsignedLongLong(args[0])));
+// Convert one argument per field before touching the entry, so that a bad
+// argument cannot leave a fused update half applied.
+static int atomic_entry_args(AtomicEntry *self, const char *fn, PyObject * const *args, Py_ssize_t nargs,
+                             uint64_t *values) {
+    int field;
+
+    if (nargs != atomic_entry_length(self)) {
+        PyErr_Format(PyExc_TypeError, "%s expected %d arguments", fn, (int)atomic_entry_length(self));
+        return 0;
+    }
+
+    for (field = 0; field < nargs; ++field) {
+        int bits = field < self->n64 ? 64 :
+                   field < self->n64 + self->n32 ? 32 :
+                   field < self->n64 + self->n32 + self->n16 ? 16 : 8;
+        if (!cell_from_py(args[field], bits, &values[field])) return 0;
+    }
+
+    return 1;
 }
 
-PyObject *atomic_value_64_bor(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue64.bor", 1);
-    return PyLong_FromUnsignedLongLong(atomic_fetch_or(self->val, PyLong_AsUnsignedLongLong(args[0])));
+static PyObject *atomic_entry_tuple(AtomicEntry *self, const uint64_t *values) {
+    PyObject *out;
+    int       field;
+
+    out = PyTuple_New(atomic_entry_length(self));
+    if (!out) return 0;
+
+    for (field = 0; field < atomic_entry_length(self); ++field) {
+        PyTuple_SET_ITEM(out, field, PyLong_FromUnsignedLongLong(values[field]));
+    }
+
+    return out;
 }
 
-PyObject *atomic_value_64_bxor(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue64.bxor", 1);
-    return PyLong_FromUnsignedLongLong(atomic_fetch_xor(self->val, PyLong_AsUnsignedLongLong(args[0])));
+static void atomic_entry_get(AtomicEntry *self, uint64_t *values) {
+#define LOAD(cell) values[field] = atomic_load(cell)
+    ATOMIC_ENTRY_EACH(LOAD)
+#undef LOAD
 }
 
-PyObject *atomic_value_64_cas(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue64.cas", 2);
-    atomic_dict64_t expected = PyLong_AsUnsignedLongLong(args[0]);
-    atomic_dict64_t desired  = PyLong_AsUnsignedLongLong(args[1]);
-    atomic_compare_exchange_strong(self->val, &expected, desired);
-    return PyLong_FromUnsignedLongLong(expected);
+static void atomic_entry_set(AtomicEntry *self, const uint64_t *values) {
+#define STORE(cell) atomic_store(cell, values[field])
+    ATOMIC_ENTRY_EACH(STORE)
+#undef STORE
+
+    dirty_mark(&self->dirty);
 }
 
+PyObject *atomic_entry_load(AtomicEntry *self, PyObject * const *args, Py_ssize_t nargs) {
+    uint64_t values[ATOMIC_ENTRY_FIELDS];
 
-PyObject *atomic_value_32_load(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue32.load", 0);
-    return PyLong_FromUnsignedLong(atomic_load(self->val));
+    CHECK_ARGN("AtomicEntry.load", 0);
+
+    atomic_entry_get(self, values);
+    return atomic_entry_tuple(self, values);
 }
 
-PyObject *atomic_value_32_store(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue32.store", 1);
-    atomic_store(self->val, PyLong_AsUnsignedLong(args[0]));
+PyObject *atomic_entry_store(AtomicEntry *self, PyObject * const *args, Py_ssize_t nargs) {
+    uint64_t values[ATOMIC_ENTRY_FIELDS];
+
+    if (!atomic_entry_args(self, "AtomicEntry.store", args, nargs, values)) return 0;
+
+    atomic_entry_set(self, values);
     Py_RETURN_NONE;
 }
 
-PyObject *atomic_value_32_swap(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue32.swap", 1);
-    return PyLong_FromUnsignedLong(atomic_exchange(self->val, PyLong_AsUnsignedLong(args[0])));
+PyObject *atomic_entry_add(AtomicEntry *self, PyObject * const *args, Py_ssize_t nargs) {
+    uint64_t values[ATOMIC_ENTRY_FIELDS];
+
+    if (!atomic_entry_args(self, "AtomicEntry.add", args, nargs, values)) return 0;
+
+    // All fields share the row's cache line, so the line is only fetched once
+#define ADD(cell) values[field] = atomic_fetch_add(cell, values[field])
+    ATOMIC_ENTRY_EACH(ADD)
+#undef ADD
+
+    dirty_mark(&self->dirty);
+
+    return atomic_entry_tuple(self, values);
 }
 
-PyObject *atomic_value_32_add(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue32.add", 1);
-    return PyLong_FromUnsignedLong(atomic_fetch_add(self->val, PyLong_AsUnsignedLong(args[0])));
+
+int direct_array_init(DirectArray *self, PyObject *args, PyObject *kwds) {
+    PyObject *memory_view;
+    Py_buffer *buffer;
+    Py_ssize_t length;
+    int bits;
+
+    if (!PyArg_ParseTuple(args, "Oin|", &memory_view, &bits, &length)) {
+        return -1;
+    }
+
+    buffer = PyMemoryView_GET_BUFFER(memory_view);
+    if (!buffer)
+        return -1;
+
+    if (bits != 64 && bits != 32 && bits != 16 && bits != 8) {
+        PyErr_SetString(PyExc_ValueError, "DirectArray cells must be 8, 16, 32 or 64 bits");
+        return -1;
+    }
+
+    if (length < 0 || length > buffer->len / (bits / 8)) {
+        PyErr_SetString(PyExc_ValueError, "DirectArray length exceeds the buffer");
+        return -1;
+    }
+
+    self->cells = buffer->buf;
+    self->bits = bits;
+    self->length = length;
+
+    return 0;
 }
 
-PyObject *atomic_value_32_sub(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue32.sub", 1);
-    return PyLong_FromUnsignedLong(atomic_fetch_sub(self->val, PyLong_AsUnsignedLong(args[0])));
+static int direct_array_offset(DirectArray *self, PyObject *arg, Py_ssize_t *offset) {
+    *offset = PyLong_AsSsize_t(arg);
+    if (*offset == -1 && PyErr_Occurred()) return 0;
+
+    if (*offset < 0 || *offset >= self->length) {
+        PyErr_SetString(PyExc_IndexError, "DirectArray index out of range");
+        return 0;
+    }
+
+    return 1;
 }
 
-PyObject *atomic_value_32_band(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue32.band", 1);
-    return PyLong_FromUnsignedLong(atomic_fetch_and(self->val, PyLong_AsUnsignedLong(args[0])));
+PyObject *direct_array_index(DirectArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    Py_ssize_t offset;
+
+    CHECK_ARGN("DirectArray.index", 1);
+
+    if (!direct_array_offset(self, args[0], &offset)) return 0;
+
+#define DIRECT_ARRAY_VALUE(bits) {                                                \
+        AtomicValue##bits *out = PyObject_New(AtomicValue##bits, &AtomicValue##bits##Type); \
+        if (out) {                                                                          \
+            out->val = (atomic_dict##bits##_t *)self->cells + offset;                       \
+            out->dirty.word = 0;                                                            \
+        }                                                                                   \
+        return (PyObject*)out;                                                              \
+    }
+
+    switch (self->bits) {
+    case 64: DIRECT_ARRAY_VALUE(64)
+    case 32: DIRECT_ARRAY_VALUE(32)
+    case 16: DIRECT_ARRAY_VALUE(16)
+    default: DIRECT_ARRAY_VALUE(8)
+    }
+
+#undef DIRECT_ARRAY_VALUE
 }
 
-PyObject *atomic_value_32_bor(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue32.bor", 1);
-    return PyLong_FromUnsignedLong(atomic_fetch_or(self->val, PyLong_AsUnsignedLong(args[0])));
+// Acquire the index and value buffers of a bulk operation, checking that
+// they agree in length and that every index is in range.
+// Whether a buffer holds integers in native byte order; a buffer without a format holds unsigned bytes
+static int buffer_is_integer(const Py_buffer *buffer) {
+    const char *format = buffer->format;
+
+    if (!format) return 1;
+    if (*format == '@' || *format == '=' || *format == (PY_LITTLE_ENDIAN ? '<' : '>')) ++format;
+
+    return format[0] && strchr("bBhHiIlLqQnN", format[0]) && !format[1];
 }
 
-PyObject *atomic_value_32_bxor(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue32.bxor", 1);
-    return PyLong_FromUnsignedLong(atomic_fetch_xor(self->val, PyLong_AsUnsignedLong(args[0])));
+static int direct_array_buffers(DirectArray *self, const char *fn, PyObject * const *args,
+                                 int writable, Py_buffer *indices, Py_buffer *values) {
+    const uint64_t *index;
+    Py_ssize_t      count;
+    Py_ssize_t      i;
+
+    if (PyObject_GetBuffer(args[0], indices, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) return 0;
+
+    if (PyObject_GetBuffer(args[1], values, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0)) < 0) {
+        PyBuffer_Release(indices);
+        return 0;
+    }
+
+    if (indices->itemsize != 8 || !buffer_is_integer(indices)) {
+        PyErr_Format(PyExc_ValueError, "%s indices must be 64-bit integers", fn);
+    } else if (values->itemsize != self->bits / 8 || !buffer_is_integer(values)) {
+        PyErr_Format(PyExc_ValueError, "%s values must be %d-bit integers", fn, self->bits);
+    } else if (indices->len / 8 != values->len / values->itemsize) {
+        PyErr_Format(PyExc_ValueError, "%s indices and values differ in length", fn);
+    } else {
+        index = (const uint64_t *)indices->buf;
+        count = indices->len / 8;
+        for (i = 0; i < count; ++i) {
+            if (index[i] >= (uint64_t)self->length) break;
+        }
+        if (i == count) return 1;
+        PyErr_Format(PyExc_IndexError, "%s index out of range", fn);
+    }
+
+    PyBuffer_Release(values);
+    PyBuffer_Release(indices);
+    return 0;
 }
 
-PyObject *atomic_value_32_cas(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("AtomicValue32.cas", 2);
-    atomic_dict32_t expected = PyLong_AsUnsignedLong(args[0]);
-    atomic_dict32_t desired  = PyLong_AsUnsignedLong(args[1]);
-    atomic_compare_exchange_strong(self->val, &expected, desired);
-    return PyLong_FromUnsignedLong(expected);
+#define DIRECT_ARRAY_BULK(op)                                                        \
+    switch (self->bits) {                                                             \
+    case 64: op(64); break;                                                           \
+    case 32: op(32); break;                                                           \
+    case 16: op(16); break;                                                           \
+    default: op(8); break;                                                            \
+    }
+
+PyObject *direct_array_gather(DirectArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    Py_buffer       indices;
+    Py_buffer       values;
+    const uint64_t *index;
+    Py_ssize_t      count;
+    Py_ssize_t      i;
+
+    CHECK_ARGN("DirectArray.gather", 2);
+
+    if (!direct_array_buffers(self, "DirectArray.gather", args, 1, &indices, &values)) return 0;
+
+    index = (const uint64_t *)indices.buf;
+    count = indices.len / 8;
+
+#define GATHER(bits) {                                                                \
+        atomic_dict##bits##_t *cells = self->cells;                                   \
+        uint##bits##_t *out = values.buf;                                             \
+        for (i = 0; i < count; ++i) out[i] = atomic_load(cells + index[i]);           \
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    DIRECT_ARRAY_BULK(GATHER)
+    Py_END_ALLOW_THREADS
+
+#undef GATHER
+
+    PyBuffer_Release(&values);
+    PyBuffer_Release(&indices);
+    Py_RETURN_NONE;
 }
 
+PyObject *direct_array_scatter(DirectArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    Py_buffer       indices;
+    Py_buffer       values;
+    const uint64_t *index;
+    Py_ssize_t      count;
+    Py_ssize_t      i;
 
-PyObject *dict_iterator_key(DictIterator *self, PyObject * const *args, Py_ssize_t nargs) {
-    AtomicCacheBlock *block = self->array->blocks + (self->offset / self->array->rows);
-    AtomicCacheBlock *end = self->array->blocks + self->array->num_blocks;
-    int n64 = self->array->k64 + self->array->v64;
-    int n32 = self->array->k32 + self->array->v32;
-    int o32 = self->array->rows * n64 * 2;
-    int ki;
+    CHECK_ARGN("DirectArray.scatter", 2);
 
-    CHECK_ARGN("DictIterator.key", 0);
+    if (!direct_array_buffers(self, "DirectArray.scatter", args, 0, &indices, &values)) return 0;
 
-    while (block != end) {
-        int row = self->offset % self->array->rows;
-        int set = 0;
-        if (self->array->k64) {
-            atomic_dict64_t key = atomic_load(&block->a64[row * n64]);
-            set = key != 0;
-        }
-        if (self->array->k32) {
-            atomic_dict32_t key = atomic_load(&block->a32[row * n32 + o32]);
-            set = key != 0;
-        }
-        if (set) {
-            PyObject *out = PyTuple_New(self->array->k64 + self->array->k32);
-            if (!out) return 0;
-            for (ki = 0; ki < self->array->k64; ++ki) {
-                atomic_dict64_t key = atomic_load(&block->a64[ki + row * n64]);
-                PyTuple_SetItem(out, ki, PyLong_FromUnsignedLongLong(key));
-            }
-            for (ki = 0; ki < self->array->k32; ++ki) {
-                atomic_dict32_t key = atomic_load(&block->a32[ki + row * n32 + o32]);
-                PyTuple_SetItem(out, ki + self->array->k64, PyLong_FromUnsignedLong(key));
-            }
-            return out;
-        }
-        ++self->offset;
-        if (row == self->array->rows - 1) ++block;
+    index = (const uint64_t *)indices.buf;
+    count = indices.len / 8;
+
+#define SCATTER(bits) {                                                               \
+        atomic_dict##bits##_t *cells = self->cells;                                   \
+        const uint##bits##_t *in = values.buf;                                        \
+        for (i = 0; i < count; ++i) atomic_store(cells + index[i], in[i]);            \
     }
 
+    Py_BEGIN_ALLOW_THREADS
+    DIRECT_ARRAY_BULK(SCATTER)
+    Py_END_ALLOW_THREADS
+
+#undef SCATTER
+
+    PyBuffer_Release(&values);
+    PyBuffer_Release(&indices);
     Py_RETURN_NONE;
 }
 
-PyObject *dict_iterator_value(DictIterator *self, PyObject * const *args, Py_ssize_t nargs) {
-    AtomicCacheBlock *block = self->array->blocks + (self->offset / self->array->rows);
-    AtomicCacheBlock *end = self->array->blocks + self->array->num_blocks;
-    int n64 = self->array->k64 + self->array->v64;
-    int n32 = self->array->k32 + self->array->v32;
-    int o32 = self->array->rows * n64 * 2;
+PyObject *direct_array_scatter_add(DirectArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    Py_buffer       indices;
+    Py_buffer       values;
+    const uint64_t *index;
+    Py_ssize_t      count;
+    Py_ssize_t      i;
 
-    CHECK_ARGN("DictIterator.value", 0);
+    CHECK_ARGN("DirectArray.scatter_add", 2);
 
-    while (block != end) {
-        int row = self->offset % self->array->rows;
-        int set = 0;
-        if (self->array->k64) {
-            atomic_dict64_t key = atomic_load(&block->a64[row * n64]);
-            set = key != 0;
-        }
-        if (self->array->k32) {
-            atomic_dict32_t key = atomic_load(&block->a32[row * n32 + o32]);
-            set = key != 0;
-        }
-        if (set) {
-            if (self->array->v64) {
-                atomic_dict64_t val = atomic_load(&block->a64[self->array->k64 + row * n64]);
-                return PyLong_FromUnsignedLongLong(val);
-            }
-            if (self->array->v32) {
-                atomic_dict32_t val = atomic_load(&block->a32[self->array->k32 + row * n32 + o32]);
-                return PyLong_FromUnsignedLong(val);
-            }
-            Py_RETURN_TRUE;
-        }
-        ++self->offset;
-        if (row == self->array->rows - 1) ++block;
+    if (!direct_array_buffers(self, "DirectArray.scatter_add", args, 0, &indices, &values)) return 0;
+
+    index = (const uint64_t *)indices.buf;
+    count = indices.len / 8;
+
+#define SCATTER_ADD(bits) {                                                           \
+        atomic_dict##bits##_t *cells = self->cells;                                   \
+        const uint##bits##_t *in = values.buf;                                        \
+        for (i = 0; i < count; ++i) atomic_fetch_add(cells + index[i], in[i]);        \
     }
 
+    Py_BEGIN_ALLOW_THREADS
+    DIRECT_ARRAY_BULK(SCATTER_ADD)
+    Py_END_ALLOW_THREADS
+
+#undef SCATTER_ADD
+
+    PyBuffer_Release(&values);
+    PyBuffer_Release(&indices);
     Py_RETURN_NONE;
 }
 
-PyObject *dict_iterator_next(DictIterator *self, PyObject * const *args, Py_ssize_t nargs) {
-    CHECK_ARGN("DictIterator.next", 0);
 
-    if (self->offset / self->array->rows < self->array->num_blocks) {
+// A row is in use once its first key cell has been claimed
+static int atomic_array_row_used(AtomicArray *self, AtomicCacheBlock *block, int row) {
+    if (self->k64) return atomic_load(&block->a64[row * (self->k64 + self->v64)]) != 0;
+    if (self->k32) return atomic_load(&block->a32[self->o32 + row * (self->k32 + self->v32)]) != 0;
+    return atomic_load(&block->a16[self->o16 + row * (self->k16 + self->v16)]) != 0;
+}
+
+static PyObject *atomic_array_row_key(AtomicArray *self, AtomicCacheBlock *block, int row) {
+    atomic_dict64_t *a64 = &block->a64[row * (self->k64 + self->v64)];
+    atomic_dict32_t *a32 = &block->a32[self->o32 + row * (self->k32 + self->v32)];
+    atomic_dict16_t *a16 = &block->a16[self->o16 + row * (self->k16 + self->v16)];
+    PyObject        *out;
+    int              ki;
+
+    out = PyTuple_New(self->k64 + self->k32 + self->k16);
+    if (!out) return 0;
+
+    for (ki = 0; ki < self->k64; ++ki) {
+        PyTuple_SET_ITEM(out, ki, PyLong_FromUnsignedLongLong(atomic_load(a64 + ki)));
+    }
+    for (ki = 0; ki < self->k32; ++ki) {
+        PyTuple_SET_ITEM(out, self->k64 + ki, PyLong_FromUnsignedLong(atomic_load(a32 + ki)));
+    }
+    for (ki = 0; ki < self->k16; ++ki) {
+        PyTuple_SET_ITEM(out, self->k64 + self->k32 + ki, PyLong_FromUnsignedLong(atomic_load(a16 + ki)));
+    }
+
+    return out;
+}
+
+static PyObject *atomic_array_row_value(AtomicArray *self, AtomicCacheBlock *block, int row) {
+    AtomicEntry cells;
+
+    atomic_array_row(self, block, row, &cells);
+
+    if (atomic_entry_length(&cells) > 1) return atomic_entry_load(&cells, 0, 0);
+    if (self->v64) return PyLong_FromUnsignedLongLong(atomic_load(cells.v64));
+    if (self->v32) return PyLong_FromUnsignedLong(atomic_load(cells.v32));
+    if (self->v16) return PyLong_FromUnsignedLong(atomic_load(cells.v16));
+    if (self->v8)  return PyLong_FromUnsignedLong(atomic_load(cells.v8));
+    Py_RETURN_TRUE;
+}
+
+// Return the (key, value) tuple of a row in use
+static PyObject *atomic_array_row_item(AtomicArray *self, AtomicCacheBlock *block, int row) {
+    PyObject *out;
+
+    out = PyTuple_New(2);
+    if (!out) return 0;
+
+    PyTuple_SET_ITEM(out, 0, atomic_array_row_key(self, block, row));
+    PyTuple_SET_ITEM(out, 1, atomic_array_row_value(self, block, row));
+
+    if (!PyTuple_GET_ITEM(out, 0) || !PyTuple_GET_ITEM(out, 1)) {
+        Py_DECREF(out);
+        return 0;
+    }
+
+    return out;
+}
+
+// Advance the iterator to the next row in use, returning its block (or 0 at the end)
+static AtomicCacheBlock *dict_iterator_seek(DictIterator *self, int *row) {
+    AtomicArray      *array = self->array;
+    AtomicCacheBlock *block = array->blocks + (self->offset / array->rows);
+    AtomicCacheBlock *end = array->blocks + array->num_blocks;
+    uint32_t          generation = atomic_array_generation(array);
+
+    while (block != end) {
+        int live = !array->clearable || block_is_live(block, generation);
+        *row = self->offset % array->rows;
+        if (live && atomic_array_row_used(array, block, *row)) return block;
         ++self->offset;
+        if (*row == array->rows - 1) ++block;
     }
 
+    return 0;
+}
+
+PyObject *dict_iterator_key(DictIterator *self, PyObject * const *args, Py_ssize_t nargs) {
+    AtomicCacheBlock *block;
+    int               row;
+
+    CHECK_ARGN("DictIterator.key", 0);
+
+    block = dict_iterator_seek(self, &row);
+    if (block) return atomic_array_row_key(self->array, block, row);
+
     Py_RETURN_NONE;
 }
 
+PyObject *dict_iterator_value(DictIterator *self, PyObject * const *args, Py_ssize_t nargs) {
+    AtomicCacheBlock *block;
+    int               row;
+
+    CHECK_ARGN("DictIterator.value", 0);
+
+    block = dict_iterator_seek(self, &row);
+    if (block) return atomic_array_row_value(self->array, block, row);
+
+    Py_RETURN_NONE;
+}
+
+PyObject *dict_iterator_next(DictIterator *self, PyObject * const *args, Py_ssize_t nargs) {
+    CHECK_ARGN("DictIterator.next", 0);
+
+    if (self->offset / self->array->rows < self->array->num_blocks) {
+        ++self->offset;
+    }
+
+    Py_RETURN_NONE;
+}
+
+PyObject *dict_iterator_iternext(DictIterator *self) {
+    AtomicCacheBlock *block;
+    PyObject         *out;
+    int               row;
+
+    // Returning 0 without an exception set ends the iteration
+    block = dict_iterator_seek(self, &row);
+    if (!block) return 0;
+
+    out = atomic_array_row_item(self->array, block, row);
+    ++self->offset;
+
+    return out;
+}
+
+void dict_iterator_dealloc(DictIterator *self) {
+    Py_XDECREF(self->array);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+// A cache only changes a block while holding the BUSY bit of its clock word
+static atomic_dict32_t *block_clock(AtomicArray *self, AtomicCacheBlock *block) {
+    return &block->a32[self->clock_cell];
+}
+
+// Returns 0 if the block stayed locked for ATOMIC_CLOCK_SPINS, e.g. by a writer that was killed
+static int block_lock(AtomicArray *self, AtomicCacheBlock *block) {
+    atomic_dict32_t *clock = block_clock(self, block);
+    uint32_t         seen = atomic_load(clock);
+    int              retries;
+
+    for (retries = 0; retries < ATOMIC_CLOCK_SPINS; ++retries) {
+        if (seen & ATOMIC_CLOCK_BUSY) {
+            // The writer holding the block only has a row to fill
+            seen = atomic_load(clock);
+        } else if (atomic_compare_exchange_weak(clock, &seen, seen | ATOMIC_CLOCK_BUSY)) {
+            if (retries) ATOMIC_PROBE2(cas_retry, clock, retries);
+            return 1;
+        }
+    }
+
+    ATOMIC_PROBE2(cas_retry, clock, retries);
+    return 0;
+}
+
+static void block_unlock(AtomicArray *self, AtomicCacheBlock *block) {
+    // Dropping BUSY carries into the version; reference bits set meanwhile survive
+    atomic_fetch_add(block_clock(self, block), ATOMIC_CLOCK_VERSION - ATOMIC_CLOCK_BUSY);
+}
+
+static void block_reference(AtomicArray *self, AtomicCacheBlock *block, int row) {
+    atomic_dict32_t *clock = block_clock(self, block);
+    uint32_t         bit = UINT32_C(1) << row;
+
+    // Skip the write when the bit is already set, to keep the line shared
+    if (!(atomic_load(clock) & bit)) atomic_fetch_or(clock, bit);
+}
+
+// With the block locked, wipe it if it predates the caller's generation.
+// Returns 0 if the block already belongs to a newer generation.
+static int block_refresh_locked(AtomicArray *self, AtomicCacheBlock *block, uint32_t generation) {
+    atomic_dict32_t *tag = &block->a32[ATOMIC_GENERATION_CELL];
+    uint32_t         seen = atomic_load(tag);
+    int              cell;
+
+    if (seen == generation) return 1;
+    if (((generation - seen) & ATOMIC_GENERATION_MASK) > ATOMIC_GENERATION_MASK / 2) return 0;
+
+    for (cell = 0; cell < self->clock_cell; ++cell) {
+        atomic_store(&block->a32[cell], 0);
+    }
+    atomic_fetch_and(block_clock(self, block), ~(ATOMIC_CLOCK_BUSY - 1));
+    atomic_store(tag, generation);
+
+    return 1;
+}
+
+static int atomic_array_row_is(AtomicArray *self, AtomicCacheBlock *block, int row, const AtomicCacheBlock *key) {
+    atomic_dict64_t *a64 = &block->a64[row * (self->k64 + self->v64)];
+    atomic_dict32_t *a32 = &block->a32[self->o32 + row * (self->k32 + self->v32)];
+    atomic_dict16_t *a16 = &block->a16[self->o16 + row * (self->k16 + self->v16)];
+    int              ki;
+
+    for (ki = 0; ki < self->k64; ++ki) {
+        if (atomic_load(a64 + ki) != key->a64[ki]) return 0;
+    }
+    for (ki = 0; ki < self->k32; ++ki) {
+        if (atomic_load(a32 + ki) != key->a32[ki + 2 * self->k64]) return 0;
+    }
+    for (ki = 0; ki < self->k16; ++ki) {
+        if (atomic_load(a16 + ki) != key->a16[ki + 4 * self->k64 + 2 * self->k32]) return 0;
+    }
+
+    return 1;
+}
+
+static void atomic_array_row_set_key(AtomicArray *self, AtomicCacheBlock *block, int row, const AtomicCacheBlock *key) {
+    atomic_dict64_t *a64 = &block->a64[row * (self->k64 + self->v64)];
+    atomic_dict32_t *a32 = &block->a32[self->o32 + row * (self->k32 + self->v32)];
+    atomic_dict16_t *a16 = &block->a16[self->o16 + row * (self->k16 + self->v16)];
+    int              ki;
+
+    for (ki = 0; ki < self->k64; ++ki) {
+        atomic_store(a64 + ki, key->a64[ki]);
+    }
+    for (ki = 0; ki < self->k32; ++ki) {
+        atomic_store(a32 + ki, key->a32[ki + 2 * self->k64]);
+    }
+    for (ki = 0; ki < self->k16; ++ki) {
+        atomic_store(a16 + ki, key->a16[ki + 4 * self->k64 + 2 * self->k32]);
+    }
+}
+
+// Look for key in a block without writing to it. Returns the matching row,
+// -1 if the block has a free row (so key cannot be further along), or -2.
+static int block_find(AtomicArray *self, AtomicCacheBlock *block, const AtomicCacheBlock *key,
+                            uint32_t generation) {
+    int row;
+
+    if (self->clearable && atomic_load(&block->a32[ATOMIC_GENERATION_CELL]) != generation) return -1;
+
+    for (row = 0; row < self->rows; ++row) {
+        if (!atomic_array_row_used(self, block, row)) return -1;
+        if (atomic_array_row_is(self, block, row, key)) return row;
+    }
+
+    return -2;
+}
+
+static PyObject *atomic_array_values(AtomicArray *self, AtomicEntry *cells, const uint64_t *values) {
+    if (atomic_entry_length(cells) > 1) return atomic_entry_tuple(cells, values);
+    if (atomic_entry_length(cells) == 1) return PyLong_FromUnsignedLongLong(values[0]);
+    Py_RETURN_TRUE;
+}
+
+// A forked child starts with a copy of its parent's pending counts; leave them to the parent
+static void stats_adopt(AtomicArray *self) {
+    unsigned seen = atomic_load_explicit(&forks, memory_order_relaxed);
+
+    if (self->forks == seen) return;
+
+    atomic_store_explicit(&self->hits, 0, memory_order_relaxed);
+    atomic_store_explicit(&self->misses, 0, memory_order_relaxed);
+    atomic_store_explicit(&self->evictions, 0, memory_order_relaxed);
+    self->forks = seen;
+}
+
+// Add this process's pending counts to the shared one
+static void stats_flush(atomic_dict64_t *pending, atomic_dict64_t *shared) {
+    uint64_t count = atomic_exchange_explicit(pending, 0, memory_order_relaxed);
+
+    if (count) atomic_fetch_add_explicit(shared, count, memory_order_relaxed);
+}
+
+static void stats_count(AtomicArray *self, atomic_dict64_t *pending, atomic_dict64_t *shared) {
+    stats_adopt(self);
+
+    if (atomic_fetch_add_explicit(pending, 1, memory_order_relaxed) + 1 >= ATOMIC_STATS_BATCH) {
+        stats_flush(pending, shared);
+    }
+}
+
+// Read the values of key from a cache without referencing it. Returns the row, or -1 if it is absent.
+static int cache_find(AtomicArray *self, const AtomicCacheBlock *key, uint64_t hash,
+                      AtomicCacheBlock **out_block, AtomicEntry *cells, uint64_t *values) {
+    AtomicCacheBlock *block = 0;
+    uint32_t          generation = atomic_array_generation(self);
+    uint32_t          before;
+    uint32_t          after = 0;
+    int               row = -2;
+    int               spins;
+    Py_ssize_t        index;
+    Py_ssize_t        stride;
+    Py_ssize_t        attempts;
+    Py_ssize_t        window;
+
+    window = self->num_blocks < ATOMIC_CLOCK_WINDOW ? self->num_blocks : ATOMIC_CLOCK_WINDOW;
+    index = hash & (self->num_blocks - 1);
+    stride = ((hash >> 32) & (self->num_blocks - 1)) | 1;
+
+    for (attempts = 0; row == -2 && attempts < window; ++attempts) {
+        block = self->blocks + index;
+
+        // Retry the block until no writer changed it while we read it.
+        // A block which stays locked is reported as a miss.
+        for (spins = 0;; ++spins) {
+            if (spins == ATOMIC_CLOCK_SPINS) {
+                row = -1;
+                break;
+            }
+            before = atomic_load(block_clock(self, block));
+            if (before & ATOMIC_CLOCK_BUSY) continue;
+            row = block_find(self, block, key, generation);
+            if (row >= 0) {
+                atomic_array_row(self, block, row, cells);
+                atomic_entry_get(cells, values);
+            }
+            after = atomic_load(block_clock(self, block));
+            if ((before | (ATOMIC_CLOCK_BUSY - 1)) == (after | (ATOMIC_CLOCK_BUSY - 1))) break;
+        }
+
+        index = (index + stride) & (self->num_blocks - 1);
+    }
+
+    ATOMIC_PROBE2(probe, attempts, row >= 0);
+
+    *out_block = block;
+    return row < 0 ? -1 : row;
+}
+
+PyObject *atomic_array_get(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    AtomicCacheBlock  key;
+    AtomicCacheBlock *block;
+    AtomicEntry       cells;
+    uint64_t          values[ATOMIC_ENTRY_FIELDS];
+    uint64_t          hash;
+    int               row;
+
+    CHECK_ARGN("AtomicArray.get", self->k64 + self->k32 + self->k16);
+
+    if (!self->cache) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray.get requires cache mode");
+        return 0;
+    }
+
+    if (!atomic_array_key(self, "AtomicArray.get", args, &key, &hash)) return 0;
+
+    row = cache_find(self, &key, hash, &block, &cells, values);
+    if (row < 0) {
+        stats_count(self, &self->misses, &self->header->misses);
+        Py_RETURN_NONE;
+    }
+
+    block_reference(self, block, row);
+    stats_count(self, &self->hits, &self->header->hits);
+
+    return atomic_array_values(self, &cells, values);
+}
+
+// Store values with key, evicting a row if needed; this does not need the GIL
+static void cache_put(AtomicArray *self, const AtomicCacheBlock *key, uint64_t hash, const uint64_t *values) {
+    AtomicCacheBlock *block;
+    AtomicEntry       cells;
+    uint32_t          generation;
+    uint32_t          clock;
+    int               row;
+    int               hand;
+    int               pass;
+    int               r;
+    int               installed;
+    Py_ssize_t        index;
+    Py_ssize_t        stride;
+    Py_ssize_t        step;
+    Py_ssize_t        window;
+
+    window = self->num_blocks < ATOMIC_CLOCK_WINDOW ? self->num_blocks : ATOMIC_CLOCK_WINDOW;
+    index = hash & (self->num_blocks - 1);
+    stride = ((hash >> 32) & (self->num_blocks - 1)) | 1;
+
+restart:
+    generation = atomic_array_generation(self);
+
+    // The first pass looks for the key or a free row; two more passes run
+    // CLOCK over the window, giving referenced rows a second chance.
+    for (step = 0; step < 3 * window; ++step) {
+        pass = step / window;
+        block = self->blocks + ((index + (step % window) * stride) & (self->num_blocks - 1));
+        row = -1;
+        installed = 0;
+
+        // Skip a block left locked by a dead writer
+        if (!block_lock(self, block)) continue;
+
+        if (self->clearable && !block_refresh_locked(self, block, generation)) {
+            block_unlock(self, block);
+            goto restart;
+        }
+
+        for (r = 0; r < self->rows; ++r) {
+            if (!atomic_array_row_used(self, block, r)) {
+                atomic_array_row_set_key(self, block, r, key);
+                row = r;
+                installed = 1;
+                break;
+            }
+            if (atomic_array_row_is(self, block, r, key)) {
+                row = r;
+                break;
+            }
+        }
+
+        if (row < 0 && pass > 0) {
+            // The block's version doubles as its clock hand
+            clock = atomic_load(block_clock(self, block));
+            hand = (clock / ATOMIC_CLOCK_VERSION) % self->rows;
+
+            for (r = 0; row < 0 && r < self->rows; ++r) {
+                if (!(clock & (UINT32_C(1) << (hand + r) % self->rows))) row = (hand + r) % self->rows;
+            }
+
+            // Every row was referenced again since the last pass; evict anyway
+            if (row < 0 && step == 3 * window - 1) row = hand;
+
+            if (row >= 0) {
+                atomic_array_row_set_key(self, block, row, key);
+                installed = 1;
+                stats_count(self, &self->evictions, &self->header->evictions);
+            } else {
+                atomic_fetch_and(block_clock(self, block), ~(ATOMIC_CLOCK_BUSY - 1));
+            }
+        }
+
+        if (row >= 0) {
+            atomic_array_row(self, block, row, &cells);
+            atomic_entry_set(&cells, values);
+            block_reference(self, block, row);
+            block_unlock(self, block);
+            ATOMIC_PROBE2(probe, step + 1, !installed);
+            if (installed) ATOMIC_PROBE2(insert, hash, step + 1);
+            return;
+        }
+
+        block_unlock(self, block);
+    }
+
+    // Only reached if the final block stayed locked; the value is dropped, as if evicted
+    ATOMIC_PROBE2(probe, step, 0);
+}
+
+PyObject *atomic_array_put(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    AtomicCacheBlock  key;
+    AtomicEntry       cells;
+    uint64_t          values[ATOMIC_ENTRY_FIELDS];
+    uint64_t          hash;
+    int               keys = self->k64 + self->k32 + self->k16;
+
+    if (!self->cache) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray.put requires cache mode");
+        return 0;
+    }
+
+    // Only the counts of the entry matter here
+    atomic_array_row(self, self->blocks, 0, &cells);
+
+    if (nargs != keys + atomic_entry_length(&cells)) {
+        PyErr_Format(PyExc_TypeError, "AtomicArray.put expected %d arguments", keys + (int)atomic_entry_length(&cells));
+        return 0;
+    }
+
+    if (!atomic_array_key(self, "AtomicArray.put", args, &key, &hash)) return 0;
+    if (!atomic_entry_args(&cells, "AtomicArray.put", args + keys, nargs - keys, values)) return 0;
+
+    cache_put(self, &key, hash, values);
+    Py_RETURN_NONE;
+}
+
+PyObject *atomic_array_stats(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    CHECK_ARGN("AtomicArray.stats", 0);
+
+    stats_adopt(self);
+    stats_flush(&self->hits, &self->header->hits);
+    stats_flush(&self->misses, &self->header->misses);
+    stats_flush(&self->evictions, &self->header->evictions);
+
+    return Py_BuildValue("(KKK)",
+        (unsigned long long)atomic_load(&self->header->hits),
+        (unsigned long long)atomic_load(&self->header->misses),
+        (unsigned long long)atomic_load(&self->header->evictions));
+}
+
+// Find key without installing it. Returns 0 if it is absent.
+static int atomic_array_find(AtomicArray *self, const AtomicCacheBlock *key, uint64_t hash,
+                             AtomicCacheBlock **out_block, int *out_row) {
+    uint32_t          generation = atomic_array_generation(self);
+    Py_ssize_t        index = hash & (self->num_blocks - 1);
+    Py_ssize_t        stride = ((hash >> 32) & (self->num_blocks - 1)) | 1;
+    Py_ssize_t        attempts;
+
+    // Probes fill the rows of a block in order, so a free row ends the search
+    for (attempts = 0; attempts < self->num_blocks; ++attempts) {
+        AtomicCacheBlock *block = self->blocks + index;
+        int               row = block_find(self, block, key, generation);
+
+        if (row == -1) {
+            ATOMIC_PROBE2(probe, attempts + 1, 0);
+            return 0;
+        }
+        if (row >= 0) {
+            ATOMIC_PROBE2(probe, attempts + 1, 1);
+            *out_block = block;
+            *out_row = row;
+            return 1;
+        }
+
+        index = (index + stride) & (self->num_blocks - 1);
+    }
+
+    // Every block was visited
+    ATOMIC_PROBE2(probe, attempts, 0);
+    return 0;
+}
+
+int dict_array_init(AtomicArray *self, PyObject *args, PyObject *kwds) {
+    if (atomic_array_init(self, args, kwds) < 0) return -1;
+
+    if (self->cache) {
+        PyErr_SetString(PyExc_ValueError, "DictArray and SetArray cannot be created in cache mode");
+        return -1;
+    }
+
+    return 0;
+}
+
+// Count the rows in use by scanning every block, rather than keep a shared
+// counter which every insert from every process would have to update.
+Py_ssize_t atomic_array_length(AtomicArray *self) {
+    uint32_t   generation = atomic_array_generation(self);
+    Py_ssize_t out = 0;
+    Py_ssize_t index;
+    int        row;
+
+    Py_BEGIN_ALLOW_THREADS
+    for (index = 0; index < self->num_blocks; ++index) {
+        AtomicCacheBlock *block = self->blocks + index;
+
+        if (self->clearable && !block_is_live(block, generation)) continue;
+
+        // Probes fill the rows of a block in order
+        for (row = 0; row < self->rows && atomic_array_row_used(self, block, row); ++row) ++out;
+    }
+    Py_END_ALLOW_THREADS
+
+    return out;
+}
+
+// Truth tests stop at the first row in use, but still scan every block of an empty table
+int atomic_array_bool(AtomicArray *self) {
+    uint32_t   generation = atomic_array_generation(self);
+    Py_ssize_t index;
+    int        out = 0;
+
+    Py_BEGIN_ALLOW_THREADS
+    for (index = 0; !out && index < self->num_blocks; ++index) {
+        AtomicCacheBlock *block = self->blocks + index;
+
+        if (self->clearable && !block_is_live(block, generation)) continue;
+
+        // Probes fill the rows of a block in order
+        out = atomic_array_row_used(self, block, 0);
+    }
+    Py_END_ALLOW_THREADS
+
+    return out;
+}
+
+PyObject *atomic_array_iter(AtomicArray *self) {
+    return (PyObject *)atomic_array_iterator(self, 0, 0);
+}
+
+int atomic_array_contains(AtomicArray *self, PyObject *obj) {
+    AtomicCacheBlock  key;
+    AtomicCacheBlock *block;
+    AtomicEntry       cells;
+    uint64_t          values[ATOMIC_ENTRY_FIELDS];
+    uint64_t          hash;
+    int               row;
+
+    if (!atomic_array_key_object(self, "AtomicArray.__contains__", obj, &key, &hash)) return -1;
+
+    // Membership tests are not lookups; they neither count in stats() nor keep the entry from eviction
+    if (self->cache) return cache_find(self, &key, hash, &block, &cells, values) >= 0;
+
+    return atomic_array_find(self, &key, hash, &block, &row);
+}
+
+PyObject *dict_array_subscript(AtomicArray *self, PyObject *obj) {
+    AtomicCacheBlock key;
+    uint64_t         hash;
+
+    if (!atomic_array_key_object(self, "DictArray.__getitem__", obj, &key, &hash)) return 0;
+
+    return atomic_array_lookup(self, &key, hash);
+}
+
+int dict_array_ass_subscript(AtomicArray *self, PyObject *obj, PyObject *value) {
+    AtomicCacheBlock   key;
+    AtomicCacheBlock  *block;
+    AtomicEntry        cells;
+    uint64_t           values[ATOMIC_ENTRY_FIELDS];
+    uint64_t           hash;
+    PyObject * const  *args = &value;
+    Py_ssize_t         nargs = 1;
+    int                row;
+    int                first;
+
+    if (!value) {
+        PyErr_SetString(PyExc_TypeError, "DictArray keys cannot be deleted");
+        return -1;
+    }
+
+    if (!atomic_array_key_object(self, "DictArray.__setitem__", obj, &key, &hash)) return -1;
+
+    if (PyTuple_Check(value)) {
+        args = PySequence_Fast_ITEMS(value);
+        nargs = PyTuple_GET_SIZE(value);
+    }
+
+    // Convert the values before installing the key, so a bad value leaves no entry behind
+    atomic_array_row(self, self->blocks, 0, &cells);
+    if (!atomic_entry_args(&cells, "DictArray.__setitem__", args, nargs, values)) return -1;
+
+    if (!atomic_array_probe(self, &key, hash, &block, &row, &first)) return -1;
+
+    atomic_array_row(self, block, row, &cells);
+    atomic_entry_set(&cells, values);
+    return 0;
+}
+
+PyObject *set_array_add(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    AtomicCacheBlock  key;
+    AtomicCacheBlock *block;
+    uint64_t          hash;
+    int               row;
+    int               first;
+
+    CHECK_ARGN("SetArray.add", 1);
+
+    if (!atomic_array_key_object(self, "SetArray.add", args[0], &key, &hash)) return 0;
+    if (!atomic_array_probe(self, &key, hash, &block, &row, &first)) return 0;
+
+    return PyBool_FromLong(first);
+}
+
+PyObject *atomic_array_changes(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    PyObject   *out;
+    PyObject   *item;
+    uint32_t    generation;
+    uint64_t    bits;
+    Py_ssize_t  word;
+    int         bit;
+    int         row;
+
+    CHECK_ARGN("AtomicArray.changed_since_and_reset", 0);
+
+    if (!self->dirty) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray was not created with dirty=True");
+        return 0;
+    }
+
+    out = PyList_New(0);
+    if (!out) return 0;
+
+    generation = atomic_array_generation(self);
+
+    for (word = 0; word < (self->num_blocks + 63) / 64; ++word) {
+        // Reset the bits before reading the blocks; a change made meanwhile sets its bit again
+        if (!atomic_load_explicit(self->dirty + word, memory_order_relaxed)) continue;
+        bits = atomic_exchange(self->dirty + word, 0);
+
+        for (bit = 0; bit < 64; ++bit) {
+            AtomicCacheBlock *block = self->blocks + word * 64 + bit;
+
+            if (!(bits & (UINT64_C(1) << bit))) continue;
+            if (self->clearable && !block_is_live(block, generation)) continue;
+
+            for (row = 0; row < self->rows; ++row) {
+                if (!atomic_array_row_used(self, block, row)) continue;
+
+                item = atomic_array_row_item(self, block, row);
+                if (!item || PyList_Append(out, item) < 0) {
+                    Py_XDECREF(item);
+                    Py_DECREF(out);
+                    return 0;
+                }
+                Py_DECREF(item);
+            }
+        }
+    }
+
+    return out;
+}
+
+// Copy the key cells of a row into key, returning 0 if an insert left some of them unset
+static int atomic_array_row_key_cells(AtomicArray *self, AtomicCacheBlock *block, int row, AtomicCacheBlock *key) {
+    atomic_dict64_t *a64 = &block->a64[row * (self->k64 + self->v64)];
+    atomic_dict32_t *a32 = &block->a32[self->o32 + row * (self->k32 + self->v32)];
+    atomic_dict16_t *a16 = &block->a16[self->o16 + row * (self->k16 + self->v16)];
+    int              ki;
+
+    for (ki = 0; ki < self->k64; ++ki) {
+        if (!(key->a64[ki] = atomic_load(a64 + ki))) return 0;
+    }
+    for (ki = 0; ki < self->k32; ++ki) {
+        if (!(key->a32[ki + 2 * self->k64] = atomic_load(a32 + ki))) return 0;
+    }
+    for (ki = 0; ki < self->k16; ++ki) {
+        if (!(key->a16[ki + 4 * self->k64 + 2 * self->k32] = atomic_load(a16 + ki))) return 0;
+    }
+
+    return 1;
+}
+
+// Insert every entry in blocks [start, stop) of source. Returns as atomic_array_claim if one does not fit.
+static int atomic_array_absorb(AtomicArray *self, AtomicArray *source, Py_ssize_t start, Py_ssize_t stop) {
+    AtomicCacheBlock  key;
+    AtomicCacheBlock *block;
+    AtomicEntry       cells;
+    uint64_t          values[ATOMIC_ENTRY_FIELDS];
+    uint32_t          generation = atomic_array_generation(source);
+    Py_ssize_t        index;
+    int               row;
+    int               to_row;
+    int               first;
+    int               claimed;
+
+    for (index = start; index < stop; ++index) {
+        AtomicCacheBlock *from = source->blocks + index;
+
+        if (source->clearable && !block_is_live(from, generation)) continue;
+
+        for (row = 0; row < source->rows; ++row) {
+            if (!atomic_array_row_key_cells(source, from, row, &key)) continue;
+
+            atomic_array_row(source, from, row, &cells);
+            atomic_entry_get(&cells, values);
+
+            if (self->cache) {
+                cache_put(self, &key, atomic_array_hash(self, &key), values);
+            } else {
+                claimed = atomic_array_claim(self, &key, atomic_array_hash(self, &key), &block, &to_row, &first);
+                if (claimed <= 0) return claimed;
+                atomic_array_row(self, block, to_row, &cells);
+                atomic_entry_set(&cells, values);
+            }
+        }
+    }
+
+    return 1;
+}
+
+PyObject *atomic_array_rehash(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    AtomicArray *source;
+    Py_ssize_t   start;
+    Py_ssize_t   stop;
+    int          fits;
+
+    CHECK_ARGN("AtomicArray.rehash", 3);
+
+    if (!PyObject_TypeCheck(args[0], &AtomicArrayType)) {
+        PyErr_SetString(PyExc_TypeError, "AtomicArray.rehash requires an AtomicArray source");
+        return 0;
+    }
+
+    source = (AtomicArray *)args[0];
+    if (source->k64 != self->k64 || source->k32 != self->k32 || source->k16 != self->k16 ||
+        source->v64 != self->v64 || source->v32 != self->v32 || source->v16 != self->v16 || source->v8 != self->v8) {
+        PyErr_SetString(PyExc_ValueError, "AtomicArray.rehash requires a source with the same key and value cells");
+        return 0;
+    }
+
+    start = PyLong_AsSsize_t(args[1]);
+    stop = PyLong_AsSsize_t(args[2]);
+    if (PyErr_Occurred()) return 0;
+
+    if (start < 0) start = 0;
+    if (stop > source->num_blocks) stop = source->num_blocks;
+
+    // Several threads may rehash disjoint ranges into one table at once
+    Py_BEGIN_ALLOW_THREADS
+    fits = atomic_array_absorb(self, source, start, stop);
+    Py_END_ALLOW_THREADS
+
+    if (fits <= 0) {
+        atomic_array_claim_error(fits);
+        return 0;
+    }
+
+    Py_RETURN_NONE;
+}
+
+PyObject *atomic_array_recover(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs) {
+    Py_ssize_t index;
+    int        cell;
+
+    CHECK_ARGN("AtomicArray.recover", 0);
+
+    Py_BEGIN_ALLOW_THREADS
+    for (index = 0; index < self->num_blocks; ++index) {
+        AtomicCacheBlock *block = self->blocks + index;
+        atomic_dict32_t  *tag = &block->a32[ATOMIC_GENERATION_CELL];
+
+        // Finish a wipe which was in progress when the copy was taken
+        if (self->clearable && (atomic_load(tag) & ATOMIC_GENERATION_BUSY)) {
+            for (cell = 0; cell < ATOMIC_GENERATION_CELL; ++cell) {
+                atomic_store(&block->a32[cell], 0);
+            }
+            atomic_fetch_and(tag, ATOMIC_GENERATION_MASK);
+        }
+
+        // Drop a writer's lock; the row it was filling may be torn, but stays usable
+        if (self->cache) atomic_fetch_and(block_clock(self, block), ~ATOMIC_CLOCK_BUSY);
+    }
+    Py_END_ALLOW_THREADS
+
+    Py_RETURN_NONE;
+}
+
+PyObject *read_layout(PyObject *module, PyObject * const *args, Py_ssize_t nargs) {
+    Py_buffer     view;
+    AtomicHeader *header;
+    PyObject     *out = 0;
+
+    CHECK_ARGN("read_layout", 1);
+
+    if (PyObject_GetBuffer(args[0], &view, PyBUF_SIMPLE) < 0) return 0;
+
+    header = (AtomicHeader *)view.buf;
+    if (view.len < ATOMIC_HEADER_BYTES || header->format != ATOMIC_FORMAT) {
+        PyErr_SetString(PyExc_ValueError, "read_layout requires the header of a saved AtomicArray");
+    } else {
+        out = Py_BuildValue("(iiiiNiiiNNn)",
+            header->cells[0], header->cells[1], header->cells[3], header->cells[4],
+            PyBool_FromLong(header->clearable), header->cells[2], header->cells[5], header->cells[6],
+            PyBool_FromLong(header->cache), PyBool_FromLong(header->dirty), (Py_ssize_t)header->num_blocks);
+    }
+
+    PyBuffer_Release(&view);
+    return out;
+}
+
 PyObject *get_pointer(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs) {
     CHECK_ARGN("get_pointer", 1);
 
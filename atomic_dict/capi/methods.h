@@ -5,47 +5,83 @@
 
 int atomic_array_init(AtomicArray *self, PyObject *args, PyObject *kwds);
 
+int atomic_array_track_forks(void);
+
 PyObject *atomic_array_index(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs);
 
+PyObject *atomic_array_clear(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs);
+
+PyObject *atomic_array_get(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs);
+
+PyObject *atomic_array_put(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs);
+
+PyObject *atomic_array_stats(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs);
+
+PyObject *atomic_array_rehash(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs);
+
+PyObject *atomic_array_recover(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs);
+
+PyObject *atomic_array_changes(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs);
+
 DictIterator *atomic_array_iterator(AtomicArray *self, PyObject * const *Args, Py_ssize_t nargs);
 
+Py_ssize_t atomic_array_length(AtomicArray *self);
 
-PyObject *atomic_value_64_load(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
+int atomic_array_bool(AtomicArray *self);
 
-PyObject *atomic_value_64_store(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
+PyObject *atomic_array_iter(AtomicArray *self);
 
-PyObject *atomic_value_64_swap(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
+int atomic_array_contains(AtomicArray *self, PyObject *obj);
 
-PyObject *atomic_value_64_add(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
 
-PyObject *atomic_value_64_sub(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
+int dict_array_init(AtomicArray *self, PyObject *args, PyObject *kwds);
 
-PyObject *atomic_value_64_band(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
+PyObject *dict_array_subscript(AtomicArray *self, PyObject *obj);
 
-PyObject *atomic_value_64_bor(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
+int dict_array_ass_subscript(AtomicArray *self, PyObject *obj, PyObject *value);
 
-PyObject *atomic_value_64_bxor(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
+PyObject *set_array_add(AtomicArray *self, PyObject * const *args, Py_ssize_t nargs);
 
-PyObject *atomic_value_64_cas(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
 
+#define ATOMIC_VALUE_DECLARE(bits)                                                                          \
+PyObject *atomic_value_##bits##_load(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);  \
+PyObject *atomic_value_##bits##_store(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs); \
+PyObject *atomic_value_##bits##_swap(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);  \
+PyObject *atomic_value_##bits##_add(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);   \
+PyObject *atomic_value_##bits##_sub(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);   \
+PyObject *atomic_value_##bits##_band(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);  \
+PyObject *atomic_value_##bits##_bor(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);   \
+PyObject *atomic_value_##bits##_bxor(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);  \
+PyObject *atomic_value_##bits##_max(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);   \
+PyObject *atomic_value_##bits##_min(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);   \
+PyObject *atomic_value_##bits##_cas(AtomicValue##bits *self, PyObject * const *args, Py_ssize_t nargs);
 
-PyObject *atomic_value_32_load(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs);
+ATOMIC_VALUE_DECLARE(64)
+ATOMIC_VALUE_DECLARE(32)
+ATOMIC_VALUE_DECLARE(16)
+ATOMIC_VALUE_DECLARE(8)
 
-PyObject *atomic_value_32_store(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs);
 
-PyObject *atomic_value_32_swap(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs);
+Py_ssize_t atomic_entry_length(AtomicEntry *self);
 
-PyObject *atomic_value_32_add(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs);
+PyObject *atomic_entry_field(AtomicEntry *self, Py_ssize_t field);
 
-PyObject *atomic_value_32_sub(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs);
+PyObject *atomic_entry_load(AtomicEntry *self, PyObject * const *args, Py_ssize_t nargs);
 
-PyObject *atomic_value_32_band(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs);
+PyObject *atomic_entry_store(AtomicEntry *self, PyObject * const *args, Py_ssize_t nargs);
 
-PyObject *atomic_value_32_bor(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs);
+PyObject *atomic_entry_add(AtomicEntry *self, PyObject * const *args, Py_ssize_t nargs);
 
-PyObject *atomic_value_32_bxor(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs);
 
-PyObject *atomic_value_32_cas(AtomicValue32 *self, PyObject * const *args, Py_ssize_t nargs);
+int direct_array_init(DirectArray *self, PyObject *args, PyObject *kwds);
+
+PyObject *direct_array_index(DirectArray *self, PyObject * const *args, Py_ssize_t nargs);
+
+PyObject *direct_array_gather(DirectArray *self, PyObject * const *args, Py_ssize_t nargs);
+
+PyObject *direct_array_scatter(DirectArray *self, PyObject * const *args, Py_ssize_t nargs);
+
+PyObject *direct_array_scatter_add(DirectArray *self, PyObject * const *args, Py_ssize_t nargs);
 
 
 PyObject *dict_iterator_key(DictIterator *self, PyObject * const *args, Py_ssize_t nargs);
@@ -54,7 +90,13 @@ PyObject *dict_iterator_value(DictIterator *self, PyObject * const *args, Py_ssi
 
 PyObject *dict_iterator_next(DictIterator *self, PyObject * const *args, Py_ssize_t nargs);
 
+PyObject *dict_iterator_iternext(DictIterator *self);
+
+void dict_iterator_dealloc(DictIterator *self);
+
 
 PyObject *get_pointer(AtomicValue64 *self, PyObject * const *args, Py_ssize_t nargs);
 
+PyObject *read_layout(PyObject *module, PyObject * const *args, Py_ssize_t nargs);
+
 #endif
@@ -0,0 +1,30 @@
+#ifndef ATOMIC_DICT_PROBES_H
+#define ATOMIC_DICT_PROBES_H
+
+// Static tracepoints under the provider "atomic_dict", for bpftrace or SystemTap.
+// c_build.py defines ATOMIC_DICT_USDT when systemtap's <sys/sdt.h> is installed;
+// then every probe is a single nop until a tracer attaches. Otherwise they vanish.
+//
+//   insert(hash, blocks)             a key was installed after visiting blocks, evicting one in a full cache
+//   probe(blocks, found)             a lookup visited blocks; found is 0 if the key is absent
+//   cas_retry(address, retries)      a compare-and-swap loop on address lost retries races
+//   capacity_exceeded(num_blocks)    a key did not fit anywhere in the table
+//
+// See tools/bpftrace for scripts which turn these into histograms.
+
+#ifdef ATOMIC_DICT_USDT
+
+#include <sys/sdt.h>
+
+#define ATOMIC_PROBE1(name, a)    DTRACE_PROBE1(atomic_dict, name, a)
+#define ATOMIC_PROBE2(name, a, b) DTRACE_PROBE2(atomic_dict, name, a, b)
+
+#else
+
+// Still use the arguments, so that counters kept only for a probe do not warn
+#define ATOMIC_PROBE1(name, a)    do { (void)(a); } while (0)
+#define ATOMIC_PROBE2(name, a, b) do { (void)(a); (void)(b); } while (0)
+
+#endif
+
+#endif
@@ -8,29 +8,135 @@
 
 typedef atomic_uint_least64_t atomic_dict64_t;
 typedef atomic_uint_least32_t atomic_dict32_t;
+typedef atomic_uint_least16_t atomic_dict16_t;
+typedef atomic_uint_least8_t  atomic_dict8_t;
 
 typedef union {
   atomic_dict64_t a64[8];
   atomic_dict32_t a32[16];
+  atomic_dict16_t a16[32];
+  atomic_dict8_t  a8[64];
 } AtomicCacheBlock;
 
+// Clearable arrays tag every block with the generation that last wrote it.
+// The tag lives in the final 32-bit cell; BUSY marks a block being wiped.
+#define ATOMIC_GENERATION_CELL 15
+#define ATOMIC_GENERATION_BUSY UINT32_C(0x80000000)
+#define ATOMIC_GENERATION_MASK UINT32_C(0x7FFFFFFF)
+
+// Cache arrays keep a clock word in the last free 32-bit cell of every block.
+// It holds one reference bit per row, a BUSY bit owned by the writer of the
+// block, and a version which every writer bumps so readers can detect races.
+#define ATOMIC_CLOCK_ROWS    16
+#define ATOMIC_CLOCK_BUSY    UINT32_C(0x00010000)
+#define ATOMIC_CLOCK_VERSION UINT32_C(0x00020000)
+#define ATOMIC_CLOCK_WINDOW  4
+
+// A writer holds a block for a few stores, unless it was descheduled or killed.
+// Readers and writers give up on a block after this many spins rather than wedge;
+// so do probes waiting for another process to finish wiping a cleared block.
+#define ATOMIC_CLOCK_SPINS   (1 << 20)
+
+// Cache statistics are tallied per process and added to the shared header in
+// batches, so that hits and misses do not all contend for one cache line.
+#define ATOMIC_STATS_BATCH   64
+
+// The shared memory starts with a header holding state common to all rows.
+// Mostly-read state and frequently-written counters get separate cache lines.
+typedef struct {
+  union {
+    struct {
+      atomic_dict32_t generation;
+      uint32_t        format;     // ATOMIC_FORMAT, so that a saved table can be recognized
+      uint64_t        num_blocks;
+      uint8_t         cells[7];   // k64, k32, k16, v64, v32, v16, v8
+      uint8_t         clearable;
+      uint8_t         cache;
+      uint8_t         dirty;
+    };
+    AtomicCacheBlock layout;
+  };
+  union {
+    struct {
+      atomic_dict64_t hits;
+      atomic_dict64_t misses;
+      atomic_dict64_t evictions;
+    };
+    AtomicCacheBlock counters;
+  };
+} AtomicHeader;
+
+#define ATOMIC_HEADER_BYTES 128
+
+// Saved tables are the shared memory verbatim, so they only load on machines of the same byte order.
+// Bump the low byte whenever the header or block layout changes.
+#define ATOMIC_FORMAT UINT32_C(0x41444301)
+
+// Tables created with dirty=True keep one bit per block after the blocks, in whole cache lines.
+// Every change to a block sets its bit; a scan for changes visits and resets only the dirty blocks.
+#define ATOMIC_DIRTY_BYTES(num_blocks) ((((num_blocks) + 511) / 512) * 64)
+
+// Where a handle records that it changed its block; word is 0 if nobody is tracking
+typedef struct {
+    atomic_dict64_t *word;
+    uint64_t bit;
+} AtomicDirty;
+
 typedef struct {
     PyObject_HEAD
+    AtomicHeader *header;
     AtomicCacheBlock *blocks;
-    int k64, k32, v64, v32, rows;
+    atomic_dict64_t *dirty; // the dirty bitmap, or 0 if changes are not tracked
+    int k64, k32, k16, v64, v32, v16, v8, rows, clearable, cache;
+    int o32, o16, o8; // offset of the first cell of each width, in cells of that width
+    int clock_cell;   // index of the clock word in a32, for cache arrays
     Py_ssize_t num_blocks;
+    atomic_dict64_t hits, misses, evictions; // not yet added to the header
+    unsigned forks;   // the fork count of the process which counted them
 } AtomicArray;
 
 typedef struct {
     PyObject_HEAD
     atomic_dict64_t *val;
+    AtomicDirty dirty;
 } AtomicValue64;
 
 typedef struct {
     PyObject_HEAD
     atomic_dict32_t *val;
+    AtomicDirty dirty;
 } AtomicValue32;
 
+typedef struct {
+    PyObject_HEAD
+    atomic_dict16_t *val;
+    AtomicDirty dirty;
+} AtomicValue16;
+
+typedef struct {
+    PyObject_HEAD
+    atomic_dict8_t *val;
+    AtomicDirty dirty;
+} AtomicValue8;
+
+// A row holding several values; fields are numbered from the widest cells to the narrowest
+typedef struct {
+    PyObject_HEAD
+    atomic_dict64_t *v64;
+    atomic_dict32_t *v32;
+    atomic_dict16_t *v16;
+    atomic_dict8_t  *v8;
+    int n64, n32, n16, n8;
+    AtomicDirty dirty;
+} AtomicEntry;
+
+typedef struct {
+    PyObject_HEAD
+    void *cells;
+    int bits;
+    Py_ssize_t length;
+} DirectArray;
+
 typedef struct {
     PyObject_HEAD
     AtomicArray *array;
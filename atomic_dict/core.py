@@ -1,38 +1,80 @@
 """This module provides a data structure which can be used between multiple processes."""
 
-from mmap import MAP_SHARED, PROT_READ, PROT_WRITE, mmap
+import os
+from array import array
+from concurrent.futures import ThreadPoolExecutor
+from mmap import MAP_PRIVATE, MAP_SHARED, PROT_READ, PROT_WRITE, mmap
+from typing import TYPE_CHECKING, TypeVar
 
-from atomic_dict.capi import AtomicArray, AtomicValue32, AtomicValue64, DictIterator
+from atomic_dict.capi import (HEADER_BYTES, AtomicArray, AtomicValue8, AtomicValue16, AtomicValue32, AtomicValue64, DictArray,
+                              DirectArray, SetArray, read_layout)
 
-class DictEntryIterator:
-    it: DictIterator
+if TYPE_CHECKING:
+    from _typeshed import ReadableBuffer, WriteableBuffer
 
-    def __init__(self, it: DictIterator):
-        self.it = it
+AtomicValue = AtomicValue8 | AtomicValue16 | AtomicValue32 | AtomicValue64
 
-    def __next__(self) -> tuple[tuple[int, ...], int]:
-        """Return the current element and advance the iterator."""
+T = TypeVar("T", bound="AtomicBase")
 
-        key = self.it.key()
-        val = self.it.value()
+# save() and load() move the shared memory in sequential chunks of this size
+CHECKPOINT_CHUNK = 16 << 20
 
-        if not key:
-            raise StopIteration()
+class AtomicMemory:
+    mm: mmap
+    mv: memoryview
 
-        assert val is not None
+    def __init__(self, nbytes: int) -> None:
+        # Shared so that fork()'d children update the same pages
+        self.mm = mmap(-1, nbytes, flags=MAP_SHARED, prot=PROT_WRITE | PROT_READ)
 
-        self.it.next()
-        return (key, val)
+        # Convert to a mutable view
+        self.mv = memoryview(self.mm)
 
-class AtomicBase:
-    mm: mmap
-    mv: memoryview
-    aa: AtomicArray
+    def __del__(self) -> None:
+        """Close the shared memory map uoon destruction.
 
-    def __init__(self, max_entries: int, k64: int, k32: int, v64: int, v32: int) -> None:
+        This will only close the copy held by a given process.
+        The map will stay alive until all users have called __del__.
+        """
+
+        self.mv.release()
+        try:
+            self.mm.close()
+        except BufferError:
+            # A view() is still exported; the map is unmapped once the last view is released
+            pass
+
+class AtomicBase(AtomicMemory):
+    """Size and map the shared memory for the C table (e.g. DictArray) that a subclass also derives from."""
+
+    def __init__(self, max_entries: int, k64: int, k32: int, v64: int, v32: int, clearable: bool = False,
+                 k16: int = 0, v16: int = 0, v8: int = 0, cache: bool = False, dirty: bool = False,
+                 blocks: int = 0) -> None:
+        # blocks, if given, overrides the size derived from max_entries
+        if not blocks:
+            blocks = self._blocks(max_entries, k64, k32, v64, v32, clearable, k16, v16, v8, cache)
+
+        AtomicMemory.__init__(self, self._nbytes(blocks, dirty))
+
+        # Pass the shared memory to the C base class, which follows AtomicMemory in the MRO
+        super(AtomicMemory, self).__init__(self.mv, k64, k32, v64, v32, clearable,  # type: ignore[call-arg]
+                                           k16=k16, v16=v16, v8=v8, cache=cache, dirty=dirty)
+
+    @staticmethod
+    def _nbytes(blocks: int, dirty: bool) -> int:
+        # We need 64-bytes per block, plus the shared header
+        # (and one bit per block for dirty tracking, in whole 64-byte lines)
+        return HEADER_BYTES + 64 * blocks + (64 * ((blocks + 511) // 512) if dirty else 0)
+
+    @staticmethod
+    def _blocks(max_entries: int, k64: int, k32: int, v64: int, v32: int, clearable: bool,
+                k16: int, v16: int, v8: int, cache: bool) -> int:
         # calculate how many rows per cache-block
-        nbytes = (k64 + v64) * 8 + (k32 + v32) * 4
-        rows = 64 // nbytes
+        # (clearable blocks reserve a 4-byte generation tag, caches a 4-byte clock word for up to 16 rows)
+        nbytes = (k64 + v64) * 8 + (k32 + v32) * 4 + (k16 + v16) * 2 + v8
+        rows = (64 - 4 * (clearable + cache)) // nbytes
+        if cache:
+            rows = min(rows, 16)
         if rows < 1:
             rows = 1
 
@@ -45,89 +87,223 @@ class AtomicBase:
             blocks *= 2
 
         # blocks must be at least 64 (for a 4kiB mmap)
-        if blocks < 64:
-            blocks = 64
+        return max(blocks, 64)
 
-        # We need 64-bytes per block
-        self.mm = mmap(-1, 64 * blocks, flags=MAP_SHARED, prot=PROT_WRITE | PROT_READ)
+    def save(self, path: str) -> None:
+        """Write the table to path, for load() to restore.
 
-        # Convert to a mutable view
-        self.mv = memoryview(self.mm)
+        The shared memory is copied NON-ATOMICALLY, so save() may run while other processes update the table.
+        Every entry is then saved with a recent value, but not all from the same instant.
+        The file is replaced atomically, so a crash during save() keeps the previous checkpoint.
+        """
 
-        # Pass the shared memory to C
-        self.aa = AtomicArray(self.mv, k64, k32, v64, v32)
+        tmp = path + ".tmp"
+        with open(tmp, "wb") as f:
+            for start in range(0, len(self.mv), CHECKPOINT_CHUNK):
+                f.write(self.mv[start:start + CHECKPOINT_CHUNK])
+            f.flush()
+            os.fsync(f.fileno())
 
-    def __del__(self) -> None:
-        """Close the shared memory map uoon destruction.
+        os.replace(tmp, path)
 
-        This will only close the copy held by a given process.
-        The map will stay alive until all users have called __del__.
+        # Make the rename itself durable
+        fd = os.open(os.path.dirname(os.path.abspath(path)), os.O_RDONLY)
+        try:
+            os.fsync(fd)
+        finally:
+            os.close(fd)
+
+    @classmethod
+    def load(cls: type[T], path: str, max_entries: int | None = None) -> T:
+        """Create a table holding the entries saved to path by save().
+
+        If max_entries is omitted or needs the saved size, the file is read straight into shared memory.
+        Otherwise the saved entries are rehashed, in parallel, into a table sized for max_entries.
         """
 
-        self.mv.release()
-        self.mm.close()
+        with open(path, "rb") as f:
+            k64, k32, v64, v32, clearable, k16, v16, v8, cache, dirty, blocks = read_layout(f.read(HEADER_BYTES))
+            shape = (k64, k32, v64, v32, clearable, k16, v16, v8, cache)
+
+            # AtomicDict, AtomicSet and AtomicCache each use their own kind of table
+            if (v64 + v32 + v16 + v8 == 0) != issubclass(cls, AtomicSet) or cache != issubclass(cls, AtomicCache):
+                raise ValueError(f"{path} does not hold an {cls.__name__}")
+
+            if os.fstat(f.fileno()).st_size != cls._nbytes(blocks, dirty):
+                raise ValueError(f"{path} is truncated")
+
+            out = cls.__new__(cls)
+
+            if max_entries is None or cls._blocks(max_entries, *shape) == blocks:
+                AtomicBase.__init__(out, 0, *shape, dirty=dirty, blocks=blocks)
+
+                f.seek(0)
+                for start in range(0, len(out.mv), CHECKPOINT_CHUNK):
+                    f.readinto(out.mv[start:start + CHECKPOINT_CHUNK])
+
+                out.recover()
+                return out
+
+            AtomicBase.__init__(out, max_entries, *shape, dirty=dirty)
+
+            # A private map lets AtomicArray record its layout without writing to the file
+            with mmap(f.fileno(), 0, flags=MAP_PRIVATE, prot=PROT_READ | PROT_WRITE) as mm, memoryview(mm) as mv:
+                source = AtomicArray(mv, k64, k32, v64, v32, clearable, k16=k16, v16=v16, v8=v8, cache=cache, dirty=dirty)
+
+                # Every worker inserts the entries of its own range of saved blocks
+                workers = os.cpu_count() or 1
+                step = (blocks + workers - 1) // workers
+                with ThreadPoolExecutor(workers) as pool:
+                    list(pool.map(lambda start: out.rehash(source, start, start + step), range(0, blocks, step)))
 
-    def __iter__(self) -> DictEntryIterator:
-        """NON-ATOMICALLY iterate through the AtomicDict contents."""
+                del source
 
-        return DictEntryIterator(self.aa.iterator())
+            return out
 
-class AtomicDict(AtomicBase):
-    def __init__(self, max_entries: int, k64: int = 1, k32: int = 0, v64: int = 1, v32: int = 0) -> None:
+class AtomicDict(AtomicBase, DictArray):
+    def __init__(self, max_entries: int, k64: int = 1, k32: int = 0, v64: int = 1, v32: int = 0,
+                 clearable: bool = False, k16: int = 0, v16: int = 0, v8: int = 0, dirty: bool = False) -> None:
         """Create a multi-process / multi-threaded shared dictionary.
 
         Once created, fork()'d child processes will share this map with the parent.
+        Keys are made of k64/k32/k16 cells and values of v64/v32/v16/v8 cells of that many bits.
+        A key is a non-zero integer, or a tuple with one non-zero integer per key cell.
+        dict[key] returns the AtomicValue of key (initially 0), installing key if needed.
+        `key in dict` checks for key without installing it; iteration yields (key tuple, value) pairs.
+        len(dict) scans the whole table, and `if dict:` scans until the first key, which is all of an empty table.
+        Narrower cells pack more rows into every 64-byte cache block.
+        With more than one value cell (e.g. v64=3), every key maps to an AtomicEntry of several fields.
+        With clearable=True, clear() empties the dictionary in constant time.
+        With dirty=True, changed_since_and_reset() returns the entries of the blocks changed since its last call.
         """
 
-        assert v64 + v32 == 1, "AtomicDict must have exactly one value"
-        super().__init__(max_entries, k64, k32, v64, v32)
+        assert v64 + v32 + v16 + v8 >= 1, "AtomicDict must have at least one value"
+        super().__init__(max_entries, k64, k32, v64, v32, clearable, k16, v16, v8, dirty=dirty)
 
-    def __getitem__(self, key: int | tuple[int, ...]) -> AtomicValue32 | AtomicValue64:
-        """dict[key] will return the AtomicValue associated with key
+class AtomicSet(AtomicBase, SetArray):
 
-        key must be a non-zero 64-bit unsigned integer.
-        The initial value of the AtomicValue is 0.
+    def __init__(self, max_entries: int, k64: int = 1, k32: int = 0, clearable: bool = False, k16: int = 0,
+                 dirty: bool = False) -> None:
+        """Create a multi-process / multi-threaded shared set.
+
+        Once created, fork()'d child processes will share this set with the parent.
+        Keys are made of k64/k32/k16 cells of that many bits.
+        add(key) returns True if it installed key; `key in set` does not install it.
+        len(set) scans the whole table, and `if set:` scans until the first key, which is all of an empty table.
+        With clearable=True, clear() empties the set in constant time.
+        With dirty=True, changed_since_and_reset() returns the keys in the blocks changed since its last call.
         """
 
-        if isinstance(key, int):
-            av = self.aa.index(key)
-        else:
-            av = self.aa.index(*key)
+        super().__init__(max_entries, k64, k32, 0, 0, clearable, k16, dirty=dirty)
 
-        assert not isinstance(av, bool)
-        return av
 
-    def __setitem__(self, key: int | tuple[int, ...], value: int) -> None:
-        """`dict[key] = value` will update the AtomicValue associated with key to value.
+class AtomicCache(AtomicBase, AtomicArray):
+    def __init__(self, max_entries: int, k64: int = 1, k32: int = 0, v64: int = 1, v32: int = 0,
+                 clearable: bool = False, k16: int = 0, v16: int = 0, v8: int = 0, dirty: bool = False) -> None:
+        """Create a multi-process / multi-threaded shared cache of bounded size.
 
-        key must be a non-zero 64-bit unsigned integer.
-        value must be a 64-bit unsigned integer.
+        Once created, fork()'d child processes will share this cache with the parent.
+        When the rows near a key are all taken, storing it evicts one not used recently (CLOCK).
+        Every operation touches at most a few cache blocks, and the memory never grows.
+        Values are copied in and out; there are no AtomicValue handles into a cache.
+        With dirty=True, changed_since_and_reset() returns the entries of the blocks changed since its last call.
         """
 
+        super().__init__(max_entries, k64, k32, v64, v32, clearable, k16, v16, v8, cache=True, dirty=dirty)
+
+    def get(self, key: int | tuple[int, ...], default: int | tuple[int, ...] | None = None) -> int | tuple[int, ...] | None:  # type: ignore[override]
+        """Return the value(s) cached for key, or default if it is absent."""
+
         if isinstance(key, int):
-            av = self.aa.index(key)
+            out = AtomicArray.get(self, key)
         else:
-            av = self.aa.index(*key)
+            out = AtomicArray.get(self, *key)
 
-        assert not isinstance(av, bool)
-        av.store(value)
+        return default if out is None else out
 
-class AtomicSet(AtomicBase):
+    def __getitem__(self, key: int | tuple[int, ...]) -> int | tuple[int, ...]:
+        out = self.get(key)
+        if out is None:
+            raise KeyError(key)
+        return out
 
-    def __init__(self, max_entries: int, k64: int = 1, k32: int = 0) -> None:
-        """Create a multi-process / multi-threaded shared dictionary.
+    def __setitem__(self, key: int | tuple[int, ...], value: int | tuple[int, ...]) -> None:
+        """`cache[key] = value` stores value, evicting an older entry if needed."""
 
-        Once created, fork()'d child processes will share this map with the parent.
+        keys = (key,) if isinstance(key, int) else key
+        values = (value,) if isinstance(value, int) else value
+        AtomicArray.put(self, *keys, *values)
+
+    def stats(self) -> dict[str, int]:  # type: ignore[override]
+        """Return the hit, miss and eviction counts shared by every process.
+
+        Each process adds its counts to the shared ones in batches, so the totals may lag by a few dozen
+        per process. Membership tests (`key in cache`) are not counted.
         """
 
-        super().__init__(max_entries, k64, k32, 0, 0)
+        hits, misses, evictions = AtomicArray.stats(self)
+        return {"hits": hits, "misses": misses, "evictions": evictions}
 
-    def add(self, key: int | tuple[int, ...]) -> bool:
-        if isinstance(key, int):
-            out = self.aa.index(key)
-        else:
-            out = self.aa.index(*key)
+class AtomicVector(AtomicMemory):
+    da: DirectArray
+    length: int
+    bits: int
+
+    # memoryview / array typecodes for each cell width
+    FORMATS = {8: "B", 16: "H", 32: "I", 64: "Q"}
+
+    def __init__(self, length: int, bits: int = 64) -> None:
+        """Create a multi-process / multi-threaded shared vector of atomic integers.
+
+        Entries are addressed directly by an index in range(length); there is no hashing.
+        Every cell is bits wide (8, 16, 32 or 64) and initially 0.
+        Once created, fork()'d child processes will share this vector with the parent.
+        """
 
-        assert isinstance(out, bool)
+        assert bits in self.FORMATS, "AtomicVector cells must be 8, 16, 32 or 64 bits"
+        super().__init__(max(1, length * bits // 8))
+        self.da = DirectArray(self.mv, bits, length)
+        self.length = length
+        self.bits = bits
+
+    def __len__(self) -> int:
+        return self.length
+
+    def __getitem__(self, index: int) -> AtomicValue:
+        """vector[index] will return the AtomicValue stored at index"""
+
+        return self.da.index(index)
+
+    def __setitem__(self, index: int, value: int) -> None:
+        """`vector[index] = value` will atomically store value at index"""
+
+        self.da.index(index).store(value)
+
+    def gather(self, indices: "ReadableBuffer", out: "WriteableBuffer | None" = None) -> "WriteableBuffer":
+        """Atomically load the cells at indices (a buffer of 64-bit integers) into out.
+
+        If out is not provided, a new array of the cell width is returned.
+        """
+
+        if out is None:
+            out = array(self.FORMATS[self.bits], bytes(memoryview(indices).nbytes * self.bits // 64))
+        self.da.gather(indices, out)
         return out
 
+    def scatter(self, indices: "ReadableBuffer", values: "ReadableBuffer") -> None:
+        """Atomically store values (a buffer of cell-width integers) to the cells at indices."""
+
+        self.da.scatter(indices, values)
+
+    def scatter_add(self, indices: "ReadableBuffer", values: "ReadableBuffer") -> None:
+        """Atomically add values (a buffer of cell-width integers) to the cells at indices."""
+
+        self.da.scatter_add(indices, values)
+
+    def view(self) -> memoryview:
+        """Return a read-only, NON-ATOMIC view of the cells, suitable for numpy.asarray().
+
+        The view shares memory with the AtomicVector, and keeps it mapped if the view outlives the vector.
+        """
+
+        return self.mv[:self.length * self.bits // 8].cast(self.FORMATS[self.bits]).toreadonly()
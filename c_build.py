@@ -5,9 +5,17 @@ import sys
 cmd = ['build', '--build-lib', os.getcwd()]
 sys.argv.extend(cmd)
 
+# Compile in the static tracepoints when systemtap's header is installed (ATOMIC_DICT_USDT=0 opts out)
+define_macros = []
+if os.environ.get("ATOMIC_DICT_USDT", "1") != "0" and any(
+        os.path.exists(os.path.join(include, "sys", "sdt.h")) for include in ("/usr/include", "/usr/local/include")):
+    define_macros.append(("ATOMIC_DICT_USDT", "1"))
+
 atomic_dict_capi_module = Extension(
     "atomic_dict.capi",
     sources=["atomic_dict/capi/init.c", "atomic_dict/capi/methods.c"],
+    depends=["atomic_dict/capi/doc.h", "atomic_dict/capi/methods.h", "atomic_dict/capi/probes.h", "atomic_dict/capi/types.h"],
+    define_macros=define_macros,
     extra_compile_args=["-O3"]
 )
 
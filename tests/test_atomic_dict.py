@@ -1,5 +1,225 @@
-from atomic_dict import AtomicDict
+from atomic_dict import AtomicCache, AtomicDict, AtomicSet, AtomicVector
+from atomic_dict.capi import HEADER_BYTES
+from array import array
 import multiprocessing
+import os
+import pathlib
+import pytest
+
+def test_clear() -> None:
+    d = AtomicDict(1024, clearable=True)
+    for i in range(1, 700):
+        d[i] = i
+    d.clear()
+    assert list(d) == []
+    # every phase can refill the table to capacity
+    for phase in range(3):
+        for i in range(1, 700):
+            assert d[i].add(phase) == 0
+        assert len(list(d)) == 699
+        d.clear()
+
+    s = AtomicSet(16, clearable=True)
+    assert not s
+    assert s.add(5) and not s.add(5)
+    assert s
+    s.clear()
+    assert not s
+    assert s.add(5)
+
+def test_clear_wedged() -> None:
+    s = AtomicSet(16, clearable=True)
+    s.clear()
+    # Leave every block mid-wipe, as a process killed inside clear()'s lazy wipe would
+    for block in range(HEADER_BYTES, len(s.mv), 64):
+        s.mv[block + 63] |= 0x80
+    with pytest.raises(TimeoutError):
+        s.add(5)
+    assert 5 not in s
+
+def test_entry() -> None:
+    d = AtomicDict(64, v64=2, v32=1)
+    for x in (5, 9, 2):
+        e = d[7]
+        e.add(1, x, 0)
+        e[2].max(x)
+    assert len(e) == 3
+    assert e.load() == (3, 16, 9)
+    d[8] = (1, 2, 3)
+    assert sorted(d) == [((7,), (3, 16, 9)), ((8,), (1, 2, 3))]
+
+def test_protocols() -> None:
+    d = AtomicDict(64, k64=2)
+    assert (1, 2) not in d and len(d) == 0
+    d[1, 2] = 5
+    d[(1, 3)] = 6
+    assert (1, 2) in d and (2, 1) not in d and len(d) == 2
+    assert d[1, 2].load() == 5
+    assert sorted(iter(d)) == [((1, 2), 5), ((1, 3), 6)]
+    for bad in (1, (1, 2, 3), (0, 1)):
+        with pytest.raises((TypeError, ValueError)):
+            d[bad]
+    assert len(d) == 2
+
+    s = AtomicSet(64, clearable=True)
+    assert 7 not in s and s.add(7) and 7 in s and (7,) in s
+    assert len(s) == 1
+    s.clear()
+    assert 7 not in s and len(s) == 0
+
+def test_save_load(tmp_path: pathlib.Path) -> None:
+    path = str(tmp_path / "dict")
+    d = AtomicDict(1000, v64=1, v16=1, clearable=True)
+    for i in range(1, 1000):
+        d[i] = (i, i % 100)
+    d.save(path)
+
+    assert os.listdir(tmp_path) == ["dict"]
+
+    for max_entries in (None, 1000, 5000, 1100):
+        e = AtomicDict.load(path, max_entries)
+        assert len(e) == 999 and sorted(e) == sorted(d)
+        assert e[5].add(1, 1) == (5, 5)
+
+    s = AtomicSet(100, k64=0, k32=2)
+    s.add((1, 2))
+    s.save(path)
+    assert list(AtomicSet.load(path, 50000)) == [((1, 2), True)]
+    with pytest.raises(ValueError):
+        AtomicDict.load(path)
+
+    c = AtomicCache(100)
+    c[7] = 8
+    c.save(path)
+    assert AtomicCache.load(path)[7] == 8 and AtomicCache.load(path, 10000)[7] == 8
+
+def test_dirty(tmp_path: pathlib.Path) -> None:
+    d = AtomicDict(100000, v64=2, dirty=True)
+    for i in range(1, 50000):
+        d[i].add(i, 0)
+    assert len(d.changed_since_and_reset()) == 49999
+    assert d.changed_since_and_reset() == []
+
+    d[77][1].add(5)
+    d[78].load()
+    changes = d.changed_since_and_reset()
+    assert ((77,), (77, 5)) in changes and len(changes) < 10
+
+    path = str(tmp_path / "dirty")
+    d.save(path)
+    e = AtomicDict.load(path)
+    e[5] = (1, 1)
+    assert ((5,), (1, 1)) in e.changed_since_and_reset()
+
+    c = AtomicCache(100, dirty=True)
+    c[3] = 4
+    assert c.changed_since_and_reset() == [((3,), 4)]
+    with pytest.raises(ValueError):
+        AtomicDict(10).changed_since_and_reset()
+
+def test_narrow_cells() -> None:
+    s = AtomicSet(60000, k64=0, k16=1)
+    assert all(s.add(i) for i in range(1, 60000))
+    assert not s.add(123)
+    assert sorted(k for (k,), _ in s) == list(range(1, 60000))
+
+    d = AtomicDict(1000, k64=0, k32=1, k16=1, v64=0, v16=1, v8=2, clearable=True)
+    for i in range(1, 1000):
+        e = d[i, i % 7 + 1]
+        assert e.add(i, 1, 255) == (0, 0, 0)
+        e[2].add(1)
+    assert d[5, 6].load() == (5, 1, 0)
+    assert len(list(d)) == 999
+    assert sorted(d)[0] == ((1, 2), (1, 1, 0))
+    for bad in (lambda: d[5, 6].store(1, 1, 256), lambda: d[5, 6].add(1 << 16, 0, 0), lambda: d[5, 6][1].store(300)):
+        with pytest.raises(OverflowError):
+            bad()
+    assert d[5, 6].load() == (5, 1, 0)
+
+def test_key_width() -> None:
+    s = AtomicSet(100, k64=0, k32=1, k16=1)
+    for key in ((2**32 + 1, 1), (1, 2**16 + 1), (1, 2**16), (2**32, 1)):
+        with pytest.raises(OverflowError):
+            s.add(key)
+        with pytest.raises(OverflowError):
+            key in s
+    assert len(s) == 0 and list(s) == []
+    assert s.add((2**32 - 1, 2**16 - 1)) and (2**32 - 1, 2**16 - 1) in s and (1, 1) not in s
+
+def test_cache() -> None:
+    c = AtomicCache(1000)
+    for i in range(1, 100000):
+        c[i] = i
+        assert c[i] == i
+    assert len(list(c)) < 2 * 1000
+    stats = c.stats()
+    assert stats["hits"] == 99999 and stats["evictions"] > 90000
+    assert c.get(1) is None and stats["misses"] + 1 == c.stats()["misses"]
+    stats = c.stats()
+    assert 99999 in c and 1 not in c and c.stats() == stats
+
+    e = AtomicCache(100, v64=2, clearable=True)
+    e[5] = (1, 2)
+    assert e[5] == (1, 2)
+    e.clear()
+    assert 5 not in e
+
+def test_cache_stats_fork() -> None:
+    c = AtomicCache(100)
+    c[1] = 1
+    for i in range(10):
+        c.get(i + 2)
+    c.get(1)
+    pid = os.fork()
+    if pid == 0:
+        # The parent's pending counts are its own to publish; the child's are not thrown away
+        c.get(100)
+        os._exit(0 if c.stats() == {"hits": 0, "misses": 1, "evictions": 0} else 1)
+    assert os.waitpid(pid, 0)[1] == 0
+    assert c.stats() == {"hits": 1, "misses": 11, "evictions": 0}
+
+def test_cache_wedged() -> None:
+    c = AtomicCache(100)
+    c[1] = 2
+    # Leave every clock word locked, as a writer killed mid-put would
+    for block in range(HEADER_BYTES, len(c.mv), 64):
+        c.mv[block + 4 * 15 + 2] |= 1
+    assert c.get(1) is None
+    c[3] = 4
+    assert c.get(3) is None
+
+def test_vector() -> None:
+    for bits, typecode in ((8, "B"), (16, "H"), (32, "I"), (64, "Q")):
+        v = AtomicVector(100, bits)
+        assert len(v) == 100
+        v[3] = 7
+        assert v[3].add(1) == 7
+        assert v[3].cas(8, 1 << (bits - 1)) == 8
+        idx = array("Q", [3, 5, 5, 99])
+        v.scatter_add(idx, array(typecode, [1, 2, 3, 4]))
+        assert list(v.gather(idx)) == [(1 << (bits - 1)) + 1, 5, 5, 4]
+        v.scatter(array("Q", [0]), array(typecode, [9]))
+        assert v.view()[0] == 9
+        with pytest.raises(ValueError):
+            v.scatter(array("d", [0.0]), array(typecode, [1]))
+        if bits >= 32:
+            with pytest.raises(ValueError):
+                v.gather(idx, array("f" if bits == 32 else "d", [0.0] * 4))
+        for bad in (lambda: v.__setitem__(0, 1 << bits), lambda: v[0].cas(0, 1 << bits)):
+            with pytest.raises(OverflowError):
+                bad()
+        assert v[0].sub(10) == 9 and v[0].load() == (1 << bits) - 1
+        for bad in (lambda: v[100], lambda: v.scatter(array("Q", [100]), array(typecode, [1]))):
+            with pytest.raises(IndexError):
+                bad()
+
+@pytest.mark.filterwarnings("error::pytest.PytestUnraisableExceptionWarning")
+def test_vector_view_outlives() -> None:
+    v = AtomicVector(4, 32)
+    v[1] = 7
+    view = v.view()
+    del v
+    assert view[1] == 7
 
 if __name__ == "__main__":
     dict = AtomicDict(1024*1024)